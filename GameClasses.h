@@ -9,13 +9,579 @@
 #include <ctime>
 #include <cstdlib>
 #include <fstream>
+#include <sstream>
+#include <map>
+#include <cmath>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <filesystem>
+#include <cstdio>
+#include <cstring>
+#include <charconv>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || defined(__AVX__)
+#include <immintrin.h>
+#endif
+#ifdef GALAXY_PROFILER
+#include <chrono>
+#include <iomanip>
+#endif
 
 using namespace std;
 
 
 
 
-string currentPlayerName = "Player";
+/// purpose: set once at startup when the game runs without a window (e.g. --simulate); skips gpu, audio and font work.
+bool headlessMode = false;
+
+
+/// purpose: sink for gameplay log lines; silenced in headless mode so batch simulations do not flood stdout.
+/// return: cout normally, a stream that discards everything when headless (one per thread, as writes set its state).
+ostream& gameLog() {
+    static thread_local ostream silent(nullptr);
+    return headlessMode ? silent : cout;
+}
+
+
+
+
+/// purpose: running FNV-1a hash; feed it raw bytes of state to get a cheap fingerprint for divergence checks.
+unsigned int hashBytes(unsigned int hash, const void* data, size_t size) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+const unsigned int HASH_SEED = 2166136261u;
+
+
+
+
+/// purpose: read-only view of a whole file. POSIX builds map it into memory; elsewhere it is read into a buffer.
+/// return: open() is false when the file cannot be read; an empty file opens with getSize() == 0.
+class MappedFile {
+private:
+    const char* data;
+    size_t size;
+    bool mapped;
+
+public:
+    MappedFile() : data(nullptr), size(0), mapped(false) {}
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const string& path) {
+        close();
+#ifdef _WIN32
+        ifstream fileIn(path, ios::binary | ios::ate);
+        if (!fileIn) return false;
+        size = (size_t)fileIn.tellg();
+        char* buffer = new char[size > 0 ? size : 1];
+        fileIn.seekg(0);
+        if (!fileIn.read(buffer, size)) {
+            delete[] buffer;
+            size = 0;
+            return false;
+        }
+        data = buffer;
+        return true;
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            ::close(fd);
+            return false;
+        }
+        size = (size_t)info.st_size;
+        if (size > 0) {
+            void* view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (view == MAP_FAILED) {
+                ::close(fd);
+                size = 0;
+                return false;
+            }
+            data = (const char*)view;
+            mapped = true;
+        }
+        ::close(fd);
+        return true;
+#endif
+    }
+
+    void close() {
+#ifdef _WIN32
+        delete[] data;
+#else
+        if (mapped) munmap((void*)data, size);
+#endif
+        data = nullptr;
+        size = 0;
+        mapped = false;
+    }
+
+    const char* getData() const { return data; }
+    size_t getSize() const { return size; }
+};
+
+
+
+
+const unsigned int ASSET_PACK_MAGIC = 0x4B505747;
+const unsigned int ASSET_PACK_VERSION = 1;
+const char* const ASSET_PACK_PATH = "assets.pak";
+
+
+/// purpose: one index record of assets.pak as written by the asset_packer tool; records are sorted by hash, then name.
+struct AssetPackEntry {
+    unsigned int hash;
+    unsigned int nameOffset;
+    unsigned int nameLength;
+    unsigned int reserved;
+    unsigned long long dataOffset;
+    unsigned long long dataSize;
+};
+
+
+/// purpose: every asset in one mapped file, so startup is a single open and sequential reads instead of one open
+///          per asset. Views point straight into the mapping and stay valid for the whole run.
+/// parameters: without assets.pak next to the game, isOpen() is false and assets load from their own files. Names the
+///             pack does not hold (a system font copied in by hand, say) still load from disk.
+/// return: find() hashes the name and binary-searches the index.
+class AssetPack {
+private:
+    MappedFile file;
+    const AssetPackEntry* index;
+    unsigned int entryCount;
+    const char* names;
+
+    AssetPack() : index(nullptr), entryCount(0), names(nullptr) {
+        if (!headlessMode) {
+            open(ASSET_PACK_PATH);
+        }
+    }
+
+    void open(const string& path) {
+        if (!file.open(path)) return;
+
+        const char* data = file.getData();
+        size_t size = file.getSize();
+        unsigned int header[4] = { 0, 0, 0, 0 };
+        if (size >= sizeof(header)) {
+            memcpy(header, data, sizeof(header));
+        }
+        size_t indexEnd = sizeof(header) + (size_t)header[2] * sizeof(AssetPackEntry);
+        if (header[0] != ASSET_PACK_MAGIC || header[1] != ASSET_PACK_VERSION || indexEnd > size) {
+            cout << "Ignoring " << path << ": not an asset pack this build can read" << endl;
+            file.close();
+            return;
+        }
+
+        const AssetPackEntry* entries = (const AssetPackEntry*)(data + sizeof(header));
+        for (unsigned int i = 0; i < header[2]; i++) {
+            if (indexEnd + entries[i].nameOffset + entries[i].nameLength > size ||
+                entries[i].dataOffset + entries[i].dataSize > size) {
+                cout << "Ignoring " << path << ": entry " << i << " points past the end of the file" << endl;
+                file.close();
+                return;
+            }
+        }
+
+        index = entries;
+        entryCount = header[2];
+        names = data + indexEnd;
+    }
+
+public:
+    static AssetPack& shared() {
+        static AssetPack pack;
+        return pack;
+    }
+
+    bool isOpen() const { return index != nullptr; }
+    int getEntryCount() const { return (int)entryCount; }
+
+    bool find(const string& name, const char*& data, size_t& size) const {
+        if (!isOpen()) return false;
+
+        unsigned int hash = hashBytes(HASH_SEED, name.data(), name.size());
+        unsigned int low = 0;
+        unsigned int high = entryCount;
+        while (low < high) {
+            unsigned int middle = low + (high - low) / 2;
+            if (index[middle].hash < hash) low = middle + 1;
+            else high = middle;
+        }
+
+        for (unsigned int i = low; i < entryCount && index[i].hash == hash; i++) {
+            if (index[i].nameLength == name.size() && memcmp(names + index[i].nameOffset, name.data(), name.size()) == 0) {
+                data = file.getData() + index[i].dataOffset;
+                size = (size_t)index[i].dataSize;
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+
+
+
+const unsigned int PIXEL_CACHE_MAGIC = 0x58504347;
+const unsigned int PIXEL_CACHE_VERSION = 1;
+const char* const PIXEL_CACHE_DIR = "pixelcache";
+
+
+/// purpose: header of one pixelcache/<name>.rgba file; width * height RGBA pixels follow it.
+struct PixelCacheHeader {
+    unsigned int magic;
+    unsigned int version;
+    unsigned int width;
+    unsigned int height;
+    unsigned int sourceHash;
+    unsigned int sourceSize;
+};
+
+
+/// purpose: keeps the decoded RGBA of every png and jpg from the first run, so later launches copy pixels out of a
+///          mapped file instead of decoding them again.
+/// parameters: an entry is only used while the hash and size of its source file still match, so a changed asset is
+///             decoded once more and its entry rewritten. If the folder cannot be written, images decode as before.
+/// return: decode() is false only when the source itself cannot be read or decoded.
+class PixelCache {
+private:
+    std::atomic<bool> writable;
+
+    PixelCache() : writable(true) {}
+
+    static string entryPath(const string& path) {
+        return string(PIXEL_CACHE_DIR) + "/" + path + ".rgba";
+    }
+
+    bool readEntry(const string& path, unsigned int sourceHash, size_t sourceSize, sf::Image& image) const {
+        MappedFile entry;
+        if (!entry.open(entryPath(path))) return false;
+
+        PixelCacheHeader header;
+        if (entry.getSize() < sizeof(header)) return false;
+        memcpy(&header, entry.getData(), sizeof(header));
+        if (header.magic != PIXEL_CACHE_MAGIC || header.version != PIXEL_CACHE_VERSION ||
+            header.sourceHash != sourceHash || header.sourceSize != (unsigned int)sourceSize ||
+            entry.getSize() != sizeof(header) + (size_t)header.width * header.height * 4) {
+            return false;
+        }
+
+        image.create(header.width, header.height, (const sf::Uint8*)(entry.getData() + sizeof(header)));
+        return true;
+    }
+
+    /// purpose: written under a per-thread name and renamed over the old entry, so a reader never sees half a file.
+    void writeEntry(const string& path, unsigned int sourceHash, size_t sourceSize, const sf::Image& image) {
+        if (!writable) return;
+
+        error_code error;
+        filesystem::create_directories(PIXEL_CACHE_DIR, error);
+        string finalPath = entryPath(path);
+        string tempPath = finalPath + "." + to_string(hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+
+        PixelCacheHeader header = { PIXEL_CACHE_MAGIC, PIXEL_CACHE_VERSION, image.getSize().x, image.getSize().y,
+            sourceHash, (unsigned int)sourceSize };
+        {
+            ofstream fileOut(tempPath, ios::binary);
+            fileOut.write((const char*)&header, sizeof(header));
+            fileOut.write((const char*)image.getPixelsPtr(), (streamsize)header.width * header.height * 4);
+            if (!fileOut) {
+                fileOut.close();
+                filesystem::remove(tempPath, error);
+                if (writable.exchange(false)) {
+                    cout << "Cannot write " << PIXEL_CACHE_DIR << "/, images will be decoded on every launch" << endl;
+                }
+                return;
+            }
+        }
+
+        filesystem::rename(tempPath, finalPath, error);
+        if (error) filesystem::remove(tempPath, error);
+    }
+
+public:
+    static PixelCache& shared() {
+        static PixelCache cache;
+        return cache;
+    }
+
+    /// purpose: fill image from the cache when the source is unchanged, else decode the source (pack or disk) and
+    ///          store the result for next time. Safe to call from AssetLoader's workers.
+    bool decode(const string& path, sf::Image& image) {
+        MappedFile looseFile;
+        const char* source = nullptr;
+        size_t sourceSize = 0;
+        if (!AssetPack::shared().find(path, source, sourceSize)) {
+            if (!looseFile.open(path)) return false;
+            source = looseFile.getData();
+            sourceSize = looseFile.getSize();
+        }
+
+        unsigned int sourceHash = hashBytes(HASH_SEED, source, sourceSize);
+        if (readEntry(path, sourceHash, sourceSize, image)) return true;
+
+        if (!image.loadFromMemory(source, sourceSize)) return false;
+        writeEntry(path, sourceHash, sourceSize, image);
+        return true;
+    }
+};
+
+
+
+
+const int ASSET_IMAGE = 0;
+const int ASSET_SOUND = 1;
+const int ASSET_BYTES = 2;
+
+
+/// purpose: one file prepared by AssetLoader. A worker fills it in, then sets ready; nobody else touches it before.
+///          Decoded images and sounds are heap objects so releasing them really returns their storage.
+struct LoadedAsset {
+    string path;
+    int kind;
+    sf::Image* image;
+    sf::SoundBuffer* sound;
+    const char* bytes;
+    char* ownedBytes;
+    size_t size;
+    bool ok;
+    std::atomic<bool> ready;
+
+    LoadedAsset() : kind(ASSET_BYTES), image(nullptr), sound(nullptr), bytes(nullptr), ownedBytes(nullptr), size(0),
+        ok(false), ready(false) {}
+
+    ~LoadedAsset() {
+        releaseDecoded();
+        delete[] ownedBytes;
+    }
+
+    void releaseDecoded() {
+        delete image;
+        image = nullptr;
+        delete sound;
+        sound = nullptr;
+    }
+};
+
+
+/// purpose: decodes images and audio and reads fonts into memory on a pool of worker threads, so the main thread
+///          only uploads textures and builds objects from memory.
+/// parameters: start() takes the file list once; files that fail are simply reported as missing.
+/// return: the find* lookups return nothing until a file is ready, and callers then load it themselves as before.
+class AssetLoader {
+private:
+    LoadedAsset* assets;
+    int assetCount;
+    map<string, int> indexByPath;
+    std::atomic<int> nextIndex;
+    std::atomic<int> doneCount;
+    std::thread* workers;
+    int workerCount;
+
+    static int kindFor(const string& path) {
+        size_t dot = path.rfind('.');
+        string extension = (dot == string::npos) ? "" : path.substr(dot);
+        if (extension == ".png" || extension == ".jpg") return ASSET_IMAGE;
+        if (extension == ".wav" || extension == ".ogg") return ASSET_SOUND;
+        return ASSET_BYTES;
+    }
+
+    /// purpose: images go through PixelCache; fonts from the pack are only pointed at, since the mapping outlives
+    ///          them, and loose fonts are read in.
+    static void decode(LoadedAsset& asset) {
+        const AssetPack& pack = AssetPack::shared();
+        const char* packed = nullptr;
+        size_t packedSize = 0;
+        bool inPack = pack.find(asset.path, packed, packedSize);
+
+        if (asset.kind == ASSET_IMAGE) {
+            asset.image = new sf::Image();
+            asset.ok = PixelCache::shared().decode(asset.path, *asset.image);
+        }
+        else if (asset.kind == ASSET_SOUND) {
+            asset.sound = new sf::SoundBuffer();
+            asset.ok = inPack ? asset.sound->loadFromMemory(packed, packedSize) : asset.sound->loadFromFile(asset.path);
+        }
+        else if (inPack) {
+            asset.bytes = packed;
+            asset.size = packedSize;
+            asset.ok = true;
+        }
+        else {
+            ifstream fileIn(asset.path, ios::binary | ios::ate);
+            if (!fileIn) return;
+            asset.size = (size_t)fileIn.tellg();
+            asset.ownedBytes = new char[asset.size > 0 ? asset.size : 1];
+            fileIn.seekg(0);
+            asset.ok = (bool)fileIn.read(asset.ownedBytes, asset.size);
+            asset.bytes = asset.ownedBytes;
+        }
+    }
+
+    void workerLoop() {
+        while (true) {
+            int index = nextIndex.fetch_add(1);
+            if (index >= assetCount) return;
+
+            decode(assets[index]);
+            assets[index].ready.store(true, memory_order_release);
+            doneCount.fetch_add(1);
+        }
+    }
+
+    const LoadedAsset* find(const string& path, int kind) const {
+        auto it = indexByPath.find(path);
+        if (it == indexByPath.end()) return nullptr;
+
+        const LoadedAsset& asset = assets[it->second];
+        if (asset.kind != kind || !asset.ready.load(memory_order_acquire) || !asset.ok) return nullptr;
+        return &asset;
+    }
+
+public:
+    AssetLoader() : assets(nullptr), assetCount(0), nextIndex(0), doneCount(0), workers(nullptr), workerCount(0) {}
+
+    ~AssetLoader() {
+        wait();
+        delete[] assets;
+    }
+
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+
+    static AssetLoader& shared() {
+        static AssetLoader loader;
+        return loader;
+    }
+
+    /// parameters: threads <= 0 uses every core but the one running the game, at most four.
+    void start(const string* paths, int count, int threads = 0) {
+        if (assets != nullptr) return;
+
+        assets = new LoadedAsset[count > 0 ? count : 1];
+        assetCount = count;
+        for (int i = 0; i < count; i++) {
+            assets[i].path = paths[i];
+            assets[i].kind = kindFor(paths[i]);
+            indexByPath[paths[i]] = i;
+        }
+
+        if (threads <= 0) {
+            threads = (int)std::thread::hardware_concurrency() - 1;
+            if (threads < 1) threads = 1;
+            if (threads > 4) threads = 4;
+        }
+        workerCount = threads;
+        workers = new std::thread[workerCount];
+        for (int i = 0; i < workerCount; i++) {
+            workers[i] = std::thread(&AssetLoader::workerLoop, this);
+        }
+    }
+
+    /// purpose: block until every queued file has been processed.
+    void wait() {
+        for (int i = 0; i < workerCount; i++) {
+            workers[i].join();
+        }
+        delete[] workers;
+        workers = nullptr;
+        workerCount = 0;
+    }
+
+    int getTotal() const { return assetCount; }
+    int getDone() const { return doneCount.load(); }
+    bool isDone() const { return doneCount.load() == assetCount; }
+
+    const sf::Image* findImage(const string& path) const {
+        const LoadedAsset* asset = find(path, ASSET_IMAGE);
+        return asset != nullptr ? asset->image : nullptr;
+    }
+
+    const sf::SoundBuffer* findSound(const string& path) const {
+        const LoadedAsset* asset = find(path, ASSET_SOUND);
+        return asset != nullptr ? asset->sound : nullptr;
+    }
+
+    bool findBytes(const string& path, const char*& data, size_t& size) const {
+        const LoadedAsset* asset = find(path, ASSET_BYTES);
+        if (asset == nullptr) return false;
+        data = asset->bytes;
+        size = asset->size;
+        return true;
+    }
+
+    /// purpose: free decoded pixels and samples once they have been copied out. Font bytes stay, since sf::Font
+    ///          keeps reading glyphs from the memory it was loaded from.
+    void releaseDecoded() {
+        wait();
+        for (int i = 0; i < assetCount; i++) {
+            assets[i].releaseDecoded();
+        }
+    }
+};
+
+
+/// purpose: load a font from the bytes AssetLoader already read, else from the asset pack or from disk.
+bool loadFontAsset(sf::Font& font, const string& path) {
+    const char* data = nullptr;
+    size_t size = 0;
+    if (AssetLoader::shared().findBytes(path, data, size)) {
+        return font.loadFromMemory(data, size);
+    }
+    if (AssetPack::shared().find(path, data, size)) {
+        return font.loadFromMemory(data, size);
+    }
+    return font.loadFromFile(path);
+}
+
+
+/// purpose: copy a sound AssetLoader already decoded, else decode it from the asset pack or from disk.
+bool loadSoundAsset(sf::SoundBuffer& buffer, const string& path) {
+    const sf::SoundBuffer* decoded = AssetLoader::shared().findSound(path);
+    if (decoded != nullptr) {
+        buffer = *decoded;
+        return true;
+    }
+    const char* data = nullptr;
+    size_t size = 0;
+    if (AssetPack::shared().find(path, data, size)) {
+        return buffer.loadFromMemory(data, size);
+    }
+    return buffer.loadFromFile(path);
+}
+
+
+/// purpose: open streamed music from the asset pack, else from disk.
+bool openMusicAsset(sf::Music& music, const string& path) {
+    const char* data = nullptr;
+    size_t size = 0;
+    if (AssetPack::shared().find(path, data, size)) {
+        return music.openFromMemory(data, size);
+    }
+    return music.openFromFile(path);
+}
 
 
 
@@ -216,6 +782,128 @@ public:
 
 
 
+/// purpose: PCG32 generator; each object is an independent, seedable sequence, so levels and subsystems never share
+///          hidden state the way the global rand() does and can run on different threads.
+/// parameters: seed picks the position in the sequence; stream selects one of 2^63 non-overlapping sequences.
+/// return: next yields 32 random bits; below and uniform map them to [0, bound) and [0, 1).
+class RandomStream {
+private:
+    unsigned long long state;
+    unsigned long long increment;
+
+public:
+    RandomStream(unsigned long long seed = 0, unsigned long long stream = 0) {
+        reseed(seed, stream);
+    }
+
+    void reseed(unsigned long long seed, unsigned long long stream) {
+        state = 0;
+        increment = (stream << 1) | 1u;
+        next();
+        state += seed;
+        next();
+    }
+
+    unsigned int next() {
+        unsigned long long old = state;
+        state = old * 6364136223846793005ULL + increment;
+        unsigned int xorShifted = (unsigned int)(((old >> 18) ^ old) >> 27);
+        unsigned int rotation = (unsigned int)(old >> 59);
+        return (xorShifted >> rotation) | (xorShifted << ((0u - rotation) & 31));
+    }
+
+    /// return: integer in [0, bound), by multiply-shift instead of the slower and biased modulo.
+    int below(int bound) {
+        return (int)(((unsigned long long)next() * (unsigned int)bound) >> 32);
+    }
+
+    float uniform() {
+        return (next() >> 8) / 16777216.0f;
+    }
+};
+
+
+
+
+const int STARFIELD_STARS = 200;
+
+
+/// purpose: one backdrop of stars shared by every menu screen, kept in a single vertex array (one draw call).
+/// parameters: setMotion turns on a slow three-layer parallax drift and brightness twinkle.
+/// return: draw rebuilds vertices only while motion is enabled; a still field is built once.
+class Starfield {
+private:
+    float starX[STARFIELD_STARS];
+    float starY[STARFIELD_STARS];
+    float radius[STARFIELD_STARS];
+    float brightness[STARFIELD_STARS];
+    float phase[STARFIELD_STARS];
+    sf::VertexArray vertices;
+    sf::Clock clock;
+    bool parallax;
+    bool twinkle;
+    bool built;
+
+    Starfield() : vertices(sf::Triangles, STARFIELD_STARS * 6), parallax(false), twinkle(false), built(false) {
+        RandomStream random((unsigned long long)time(nullptr));
+        for (int i = 0; i < STARFIELD_STARS; i++) {
+            radius[i] = 1.0f + random.below(3);
+            starX[i] = random.uniform() * 1920.0f;
+            starY[i] = random.uniform() * 1080.0f;
+            brightness[i] = 150.0f + random.uniform() * 100.0f;
+            phase[i] = random.uniform() * 6.2831853f;
+        }
+    }
+
+    void rebuild(float t) {
+        for (int i = 0; i < STARFIELD_STARS; i++) {
+            float x = starX[i] + radius[i];
+            float y = starY[i] + radius[i];
+            if (parallax) {
+                y = std::fmod(y + t * 6.0f * radius[i], 1080.0f);
+            }
+
+            float b = brightness[i];
+            if (twinkle) {
+                b *= 0.8f + 0.2f * std::sin(t * 2.0f + phase[i]);
+            }
+            sf::Color color((sf::Uint8)b, (sf::Uint8)b, (sf::Uint8)b);
+
+            float r = radius[i];
+            sf::Vertex* quad = &vertices[i * 6];
+            quad[0] = sf::Vertex(sf::Vector2f(x - r, y - r), color);
+            quad[1] = sf::Vertex(sf::Vector2f(x + r, y - r), color);
+            quad[2] = sf::Vertex(sf::Vector2f(x + r, y + r), color);
+            quad[3] = quad[0];
+            quad[4] = quad[2];
+            quad[5] = sf::Vertex(sf::Vector2f(x - r, y + r), color);
+        }
+        built = true;
+    }
+
+public:
+    static Starfield& shared() {
+        static Starfield field;
+        return field;
+    }
+
+    void setMotion(bool enableParallax, bool enableTwinkle) {
+        parallax = enableParallax;
+        twinkle = enableTwinkle;
+        built = false;
+    }
+
+    void draw(sf::RenderTarget& target) {
+        if (parallax || twinkle || !built) {
+            rebuild(clock.getElapsedTime().asSeconds());
+        }
+        target.draw(vertices);
+    }
+};
+
+
+
+
 /// purpose: capture the player's name via on-screen text entry before starting gameplay.
 /// parameters: window is the shared render target; font is reused to avoid reloading resources.
 /// return: returns the confirmed player name or a default fallback if the window closes.
@@ -238,20 +926,6 @@ string getPlayerName(sf::RenderWindow& window, const sf::Font& font) {
     string playerName = "";
 
 
-    static bool starsInit = false;
-    static sf::CircleShape stars[200];
-    if (!starsInit) {
-        srand((unsigned int)time(nullptr));
-        for (int i = 0; i < 200; i++) {
-            float r = 1.0f + (rand() % 3);
-            stars[i].setRadius(r);
-            stars[i].setPosition((float)(rand() % 1920), (float)(rand() % 1080));
-            int b = 150 + rand() % 100;
-            stars[i].setFillColor(sf::Color((sf::Uint8)b, (sf::Uint8)b, (sf::Uint8)b));
-        }
-        starsInit = true;
-    }
-
     while (window.isOpen()) {
         sf::Event e;
         while (window.pollEvent(e)) {
@@ -290,9 +964,7 @@ string getPlayerName(sf::RenderWindow& window, const sf::Font& font) {
         window.clear(sf::Color(5, 5, 25));
 
 
-        for (int i = 0; i < 200; i++) {
-            window.draw(stars[i]);
-        }
+        Starfield::shared().draw(window);
 
         window.draw(title);
         window.draw(instruction);
@@ -337,11 +1009,11 @@ public:
     }
 
     bool loadFonts(const string& titlePath, const string& menuPath) {
-        if (!titleFont.loadFromFile(titlePath)) {
+        if (!loadFontAsset(titleFont, titlePath)) {
             cout << "Error loading title font";
             return false;
         }
-        if (!menuFont.loadFromFile(menuPath)) {
+        if (!loadFontAsset(menuFont, menuPath)) {
             cout << "Error loading menu font";
             return false;
         }
@@ -449,24 +1121,7 @@ public:
 
 private:
     void drawStars(sf::RenderWindow& win) {
-        static bool init = false;
-        static sf::CircleShape stars[200];
-
-        if (!init) {
-            srand((unsigned int)time(nullptr));
-            for (int i = 0; i < 200; i++) {
-                float r = 1.0f + (rand() % 3);
-                stars[i].setRadius(r);
-                stars[i].setPosition((float)(rand() % 1920), (float)(rand() % 1080));
-                int b = 150 + rand() % 100;
-                stars[i].setFillColor(sf::Color((sf::Uint8)b, (sf::Uint8)b, (sf::Uint8)b));
-            }
-            init = true;
-        }
-
-        for (int i = 0; i < 200; i++) {
-            win.draw(stars[i]);
-        }
+        Starfield::shared().draw(win);
     }
 };
 
@@ -502,7 +1157,7 @@ public:
     }
 
     bool loadFont(const string& fontPath) {
-        if (!font.loadFromFile(fontPath)) {
+        if (!loadFontAsset(font, fontPath)) {
             cout << "Failed to load intro font";
             return false;
         }
@@ -510,7 +1165,7 @@ public:
     }
 
     bool loadTypingSound(const string& soundPath) {
-        if (!typingBuffer.loadFromFile(soundPath)) {
+        if (!loadSoundAsset(typingBuffer, soundPath)) {
             cout << "Failed to load typing sound";
             return false;
         }
@@ -789,7 +1444,7 @@ public:
     }
 
     bool loadFont(const string& fontPath) {
-        if (!font.loadFromFile(fontPath)) {
+        if (!loadFontAsset(font, fontPath)) {
             cout << "Failed to load transition font";
             return false;
         }
@@ -797,7 +1452,7 @@ public:
     }
 
     bool loadSound(const string& soundPath) {
-        if (!soundBuffer.loadFromFile(soundPath)) {
+        if (!loadSoundAsset(soundBuffer, soundPath)) {
             cout << "Failed to load transition sound";
             return false;
         }
@@ -1027,7 +1682,7 @@ public:
     }
 
     bool loadFont(const string& fontPath) {
-        if (!font.loadFromFile(fontPath)) {
+        if (!loadFontAsset(font, fontPath)) {
             cout << "Failed to load victory story font";
             return false;
         }
@@ -1035,7 +1690,7 @@ public:
     }
 
     bool loadTypingSound(const string& soundPath) {
-        if (!typingBuffer.loadFromFile(soundPath)) {
+        if (!loadSoundAsset(typingBuffer, soundPath)) {
             cout << "Failed to load victory typing sound";
             return false;
         }
@@ -1344,77 +1999,1541 @@ public:
 
 
 
+/// purpose: reference to a pooled object that goes stale once the slot is released and reused.
+/// parameters: index is the pool slot (-1 when invalid), generation must match the slot's current generation.
+struct PoolHandle {
+    int index;
+    unsigned int generation;
+
+    PoolHandle() : index(-1), generation(0) {}
+    PoolHandle(int i, unsigned int g) : index(i), generation(g) {}
+
+    bool isValid() const { return index >= 0; }
+};
+
+
+
+
+/// purpose: fixed-cost object pool; a free list makes acquire/release O(1) and a dense list of live slots
+///          lets callers iterate only what is in use, independent of capacity.
+/// parameters: all size objects are allocated up front and never move, so pointers into the pool stay valid.
 template<typename T>
 class ObjectPool {
 private:
     T* objects;
-    bool* activeStates;
     int poolSize;
+
+    unsigned int* generations;
+    int* freeList;
+    int freeCount;
+    int* activeIndices;
+    int* densePositions;
     int activeCount;
 
+    void releaseSlot(int index) {
+        int position = densePositions[index];
+        int last = activeIndices[activeCount - 1];
+        activeIndices[position] = last;
+        densePositions[last] = position;
+        activeCount--;
+
+        densePositions[index] = -1;
+        generations[index]++;
+        freeList[freeCount++] = index;
+    }
+
 public:
-    ObjectPool(int size) : poolSize(size), activeCount(0) {
+    ObjectPool(int size) : poolSize(size), freeCount(0), activeCount(0) {
         objects = new T[poolSize];
-        activeStates = new bool[poolSize];
-        for (int i = 0; i < poolSize; i++) {
-            activeStates[i] = false;
+        generations = new unsigned int[poolSize];
+        freeList = new int[poolSize];
+        activeIndices = new int[poolSize];
+        densePositions = new int[poolSize];
+        for (int i = poolSize - 1; i >= 0; i--) {
+            generations[i] = 0;
+            densePositions[i] = -1;
+            freeList[freeCount++] = i;
         }
     }
 
     ~ObjectPool() {
         delete[] objects;
-        delete[] activeStates;
+        delete[] generations;
+        delete[] freeList;
+        delete[] activeIndices;
+        delete[] densePositions;
     }
 
 
-    T* getInactive() {
-        for (int i = 0; i < poolSize; i++) {
-            if (!activeStates[i]) {
-                activeStates[i] = true;
-                activeCount++;
-                return &objects[i];
-            }
+    /// purpose: take a free slot.
+    /// return: handle to the slot, or an invalid handle when the pool is exhausted.
+    PoolHandle acquire() {
+        if (freeCount == 0) {
+            return PoolHandle();
         }
-        return nullptr;
+
+        int index = freeList[--freeCount];
+        densePositions[index] = activeCount;
+        activeIndices[activeCount++] = index;
+        return PoolHandle(index, generations[index]);
     }
 
 
-    void release(T* obj) {
-        for (int i = 0; i < poolSize; i++) {
-            if (&objects[i] == obj) {
-                activeStates[i] = false;
-                activeCount--;
-                break;
-            }
+    /// return: true if the handle was live and has now been returned to the free list.
+    bool release(PoolHandle handle) {
+        if (resolve(handle) == nullptr) {
+            return false;
         }
+        releaseSlot(handle.index);
+        return true;
     }
 
 
-    T* get(int index) {
-        if (index >= 0 && index < poolSize) {
-            return &objects[index];
-        }
+    /// return: the object behind the handle, or nullptr if it was released since.
+    T* resolve(PoolHandle handle) {
+        if (handle.index < 0 || handle.index >= getPoolSize()) return nullptr;
+        if (densePositions[handle.index] < 0 || generations[handle.index] != handle.generation) return nullptr;
+        return get(handle.index);
+    }
+
+
+    /// purpose: return every slot whose object has switched itself off (left the screen, was destroyed, ...).
+    /// return: number of slots released.
+    int collectInactive() {
+        int released = 0;
+        for (int n = activeCount - 1; n >= 0; n--) {
+            int index = activeIndices[n];
+            if (!get(index)->isActive()) {
+                releaseSlot(index);
+                released++;
+            }
+        }
+        return released;
+    }
+
+
+    /// purpose: n-th live object, for iterating 0..getActiveCount()-1 without touching free slots.
+    T* getActive(int n) {
+        return get(activeIndices[n]);
+    }
+
+
+    T* get(int index) {
+        if (index >= 0 && index < getPoolSize()) {
+            return &objects[index];
+        }
         return nullptr;
     }
 
 
     bool isActive(int index) const {
-        if (index >= 0 && index < poolSize) {
-            return activeStates[index];
+        if (index >= 0 && index < getPoolSize()) {
+            return densePositions[index] >= 0;
         }
         return false;
     }
 
     int getPoolSize() const { return poolSize; }
     int getActiveCount() const { return activeCount; }
-    int getInactiveCount() const { return poolSize - activeCount; }
+    int getInactiveCount() const { return getPoolSize() - activeCount; }
 
 
+    /// purpose: release everything and restore the initial slot order, so a cleared pool hands out the same
+    ///          slots in the same order as a new one (replays depend on it).
+    void clear() {
+        for (int n = activeCount - 1; n >= 0; n--) {
+            releaseSlot(activeIndices[n]);
+        }
+        freeCount = 0;
+        for (int i = getPoolSize() - 1; i >= 0; i--) {
+            freeList[freeCount++] = i;
+        }
+    }
+};
+
+
+
+
+const int GRID_METEOR = 0;
+const int GRID_ENEMY = 1;
+const int GRID_ENEMY_BULLET = 2;
+const int GRID_POWERUP = 3;
+
+
+/// purpose: uniform-grid broadphase; bounds are inserted once per tick and queries only visit overlapping cells.
+/// parameters: worldW/worldH is the playfield; anything outside it is clamped into the border cells.
+class SpatialGrid {
+private:
+    float cellSize;
+    int columns;
+    int rows;
+    int* cellHeads;
+
+    int* nodeNext;
+    int* nodeEntry;
+    int nodeCount;
+    int nodeCapacity;
+
+    sf::FloatRect* entryBounds;
+    int* entryCategory;
+    int* entryIndex;
+    unsigned int* entryStamp;
+    int entryCount;
+    int entryCapacity;
+    unsigned int queryStamp;
+
+    int clampColumn(float x) const {
+        int c = (int)(x / cellSize);
+        if (c < 0) return 0;
+        if (c >= columns) return columns - 1;
+        return c;
+    }
+
+    int clampRow(float y) const {
+        int r = (int)(y / cellSize);
+        if (r < 0) return 0;
+        if (r >= rows) return rows - 1;
+        return r;
+    }
+
+    void growNodes() {
+        int newCapacity = nodeCapacity * 2;
+        int* newNext = new int[newCapacity];
+        int* newEntry = new int[newCapacity];
+        for (int i = 0; i < nodeCount; i++) {
+            newNext[i] = nodeNext[i];
+            newEntry[i] = nodeEntry[i];
+        }
+        delete[] nodeNext;
+        delete[] nodeEntry;
+        nodeNext = newNext;
+        nodeEntry = newEntry;
+        nodeCapacity = newCapacity;
+    }
+
+    void growEntries() {
+        int newCapacity = entryCapacity * 2;
+        sf::FloatRect* newBounds = new sf::FloatRect[newCapacity];
+        int* newCategory = new int[newCapacity];
+        int* newIndex = new int[newCapacity];
+        unsigned int* newStamp = new unsigned int[newCapacity];
+        for (int i = 0; i < entryCount; i++) {
+            newBounds[i] = entryBounds[i];
+            newCategory[i] = entryCategory[i];
+            newIndex[i] = entryIndex[i];
+            newStamp[i] = entryStamp[i];
+        }
+        delete[] entryBounds;
+        delete[] entryCategory;
+        delete[] entryIndex;
+        delete[] entryStamp;
+        entryBounds = newBounds;
+        entryCategory = newCategory;
+        entryIndex = newIndex;
+        entryStamp = newStamp;
+        entryCapacity = newCapacity;
+    }
+
+public:
+    SpatialGrid(float worldW = 1920.0f, float worldH = 1080.0f, float cell = 128.0f)
+        : cellSize(cell), nodeCount(0), nodeCapacity(256), entryCount(0), entryCapacity(128), queryStamp(0) {
+        columns = (int)(worldW / cellSize) + 1;
+        rows = (int)(worldH / cellSize) + 1;
+        cellHeads = new int[columns * rows];
+        nodeNext = new int[nodeCapacity];
+        nodeEntry = new int[nodeCapacity];
+        entryBounds = new sf::FloatRect[entryCapacity];
+        entryCategory = new int[entryCapacity];
+        entryIndex = new int[entryCapacity];
+        entryStamp = new unsigned int[entryCapacity];
+        clear();
+    }
+
+    ~SpatialGrid() {
+        delete[] cellHeads;
+        delete[] nodeNext;
+        delete[] nodeEntry;
+        delete[] entryBounds;
+        delete[] entryCategory;
+        delete[] entryIndex;
+        delete[] entryStamp;
+    }
+
     void clear() {
-        for (int i = 0; i < poolSize; i++) {
-            activeStates[i] = false;
+        for (int i = 0; i < columns * rows; i++) {
+            cellHeads[i] = -1;
+        }
+        nodeCount = 0;
+        entryCount = 0;
+    }
+
+
+    /// parameters: bounds are cached as given; category is one of the GRID_* values; index is the caller's slot.
+    void insert(const sf::FloatRect& bounds, int category, int index) {
+        if (bounds.width <= 0.0f || bounds.height <= 0.0f) return;
+
+        if (entryCount == entryCapacity) growEntries();
+        int entry = entryCount++;
+        entryBounds[entry] = bounds;
+        entryCategory[entry] = category;
+        entryIndex[entry] = index;
+        entryStamp[entry] = queryStamp;
+
+        int c0 = clampColumn(bounds.left);
+        int c1 = clampColumn(bounds.left + bounds.width);
+        int r0 = clampRow(bounds.top);
+        int r1 = clampRow(bounds.top + bounds.height);
+        for (int r = r0; r <= r1; r++) {
+            for (int c = c0; c <= c1; c++) {
+                if (nodeCount == nodeCapacity) growNodes();
+                int cell = r * columns + c;
+                nodeEntry[nodeCount] = entry;
+                nodeNext[nodeCount] = cellHeads[cell];
+                cellHeads[cell] = nodeCount;
+                nodeCount++;
+            }
+        }
+    }
+
+
+    /// purpose: find every entry of one category whose cached bounds intersect area.
+    /// parameters: results receives caller indices in ascending order; past maxResults hits the lowest are kept.
+    /// return: number of indices written.
+    int query(const sf::FloatRect& area, int category, int* results, int maxResults) {
+        if (area.width <= 0.0f || area.height <= 0.0f || maxResults <= 0) return 0;
+
+        queryStamp++;
+        if (queryStamp == 0) {
+            for (int i = 0; i < entryCount; i++) {
+                entryStamp[i] = 0;
+            }
+            queryStamp = 1;
+        }
+        int found = 0;
+
+        int c0 = clampColumn(area.left);
+        int c1 = clampColumn(area.left + area.width);
+        int r0 = clampRow(area.top);
+        int r1 = clampRow(area.top + area.height);
+        for (int r = r0; r <= r1; r++) {
+            for (int c = c0; c <= c1; c++) {
+                for (int node = cellHeads[r * columns + c]; node != -1; node = nodeNext[node]) {
+                    int entry = nodeEntry[node];
+                    if (entryStamp[entry] == queryStamp) continue;
+                    entryStamp[entry] = queryStamp;
+
+                    if (entryCategory[entry] != category) continue;
+                    if (!area.intersects(entryBounds[entry])) continue;
+
+                    int index = entryIndex[entry];
+                    int k;
+                    if (found < maxResults) {
+                        k = found++;
+                    }
+                    else if (index < results[maxResults - 1]) {
+                        k = maxResults - 1;
+                    }
+                    else {
+                        continue;
+                    }
+                    while (k > 0 && results[k - 1] > index) {
+                        results[k] = results[k - 1];
+                        k--;
+                    }
+                    results[k] = index;
+                }
+            }
+        }
+        return found;
+    }
+
+    int getEntryCount() const { return entryCount; }
+};
+
+
+
+
+/// purpose: player intent for a single simulation tick, so levels can be driven by the keyboard, a bot or a replay.
+/// parameters: movement flags are held states; fire is the held state of the trigger (edges are detected by the level).
+struct PlayerInput {
+    bool left;
+    bool right;
+    bool up;
+    bool down;
+    bool fire;
+
+    PlayerInput() : left(false), right(false), up(false), down(false), fire(false) {}
+
+    /// return: the five buttons as bits 0..4, the per-tick unit of a replay log.
+    unsigned char pack() const {
+        return (unsigned char)((left ? 1 : 0) | (right ? 2 : 0) | (up ? 4 : 0) | (down ? 8 : 0) | (fire ? 16 : 0));
+    }
+
+    static PlayerInput unpack(unsigned char bits) {
+        PlayerInput input;
+        input.left = (bits & 1) != 0;
+        input.right = (bits & 2) != 0;
+        input.up = (bits & 4) != 0;
+        input.down = (bits & 8) != 0;
+        input.fire = (bits & 16) != 0;
+        return input;
+    }
+};
+
+
+
+
+const int ACTION_LEFT = 0;
+const int ACTION_RIGHT = 1;
+const int ACTION_UP = 2;
+const int ACTION_DOWN = 3;
+const int ACTION_FIRE = 4;
+const int ACTION_PAUSE = 5;
+const int ACTION_COUNT = 6;
+const char* const ACTION_NAMES[ACTION_COUNT] = { "left", "right", "up", "down", "fire", "pause" };
+const int INPUT_QUEUE_CAPACITY = 64;
+const char* const CONTROLS_PATH = "controls.cfg";
+
+
+/// purpose: a press or release of one gameplay action, stamped with the time it was polled.
+struct InputEvent {
+    int action;
+    bool pressed;
+    double time;
+};
+
+
+/// purpose: turns window key events into queued, timestamped actions and hands each simulation tick the ones that
+///          happened before it ended, so a tap shorter than a frame still fires.
+/// parameters: keys come from controls.cfg when present, one "action keycode" line per binding (sf::Keyboard::Key
+///             values), and default to the arrows, Space and P.
+/// return: nextTick builds the PlayerInput of one tick; pause is not queued, the game asks isBound() instead.
+class ActionInput {
+private:
+    sf::Keyboard::Key bindings[ACTION_COUNT];
+    bool held[ACTION_COUNT];
+    bool queuedHeld[ACTION_COUNT];
+    bool reported[ACTION_COUNT];
+    InputEvent queue[INPUT_QUEUE_CAPACITY];
+    int queueHead;
+    int queueCount;
+    bool tickedThisFrame;
+    sf::Clock clock;
+
+    /// purpose: a full queue folds its oldest event into the held state, so nothing is lost but that tap's timing.
+    void push(int action, bool pressed) {
+        if (queueCount == INPUT_QUEUE_CAPACITY) {
+            held[queue[queueHead].action] = queue[queueHead].pressed;
+            queueHead = (queueHead + 1) % INPUT_QUEUE_CAPACITY;
+            queueCount--;
+        }
+
+        InputEvent& event = queue[(queueHead + queueCount) % INPUT_QUEUE_CAPACITY];
+        event.action = action;
+        event.pressed = pressed;
+        event.time = now();
+        queueCount++;
+        queuedHeld[action] = pressed;
+    }
+
+public:
+    ActionInput() : queueHead(0), queueCount(0), tickedThisFrame(false) {
+        bindings[ACTION_LEFT] = sf::Keyboard::Left;
+        bindings[ACTION_RIGHT] = sf::Keyboard::Right;
+        bindings[ACTION_UP] = sf::Keyboard::Up;
+        bindings[ACTION_DOWN] = sf::Keyboard::Down;
+        bindings[ACTION_FIRE] = sf::Keyboard::Space;
+        bindings[ACTION_PAUSE] = sf::Keyboard::P;
+        for (int i = 0; i < ACTION_COUNT; i++) {
+            held[i] = false;
+            queuedHeld[i] = false;
+            reported[i] = false;
+        }
+        loadBindings(CONTROLS_PATH);
+    }
+
+    /// return: seconds since the input layer was created, the clock every event is stamped with.
+    double now() const {
+        return clock.getElapsedTime().asMicroseconds() / 1.0e6;
+    }
+
+    bool loadBindings(const string& path) {
+        ifstream bindingsIn(path);
+        if (!bindingsIn.is_open()) return false;
+
+        string line;
+        while (getline(bindingsIn, line)) {
+            if (line.empty() || line[0] == '#') continue;
+
+            istringstream fields(line);
+            string name;
+            int code;
+            if (!(fields >> name >> code) || code < 0 || code >= sf::Keyboard::KeyCount) continue;
+
+            for (int i = 0; i < ACTION_COUNT; i++) {
+                if (name == ACTION_NAMES[i]) bindings[i] = (sf::Keyboard::Key)code;
+            }
+        }
+        return true;
+    }
+
+    bool isBound(int action, sf::Keyboard::Key key) const {
+        return bindings[action] == key;
+    }
+
+    /// purpose: queue changes of the movement and fire keys; key repeats are dropped, and losing focus releases
+    ///          everything, since the matching key-up events would never arrive.
+    void handleEvent(const sf::Event& e) {
+        if (e.type == sf::Event::LostFocus) {
+            for (int action = 0; action < ACTION_PAUSE; action++) {
+                if (queuedHeld[action]) push(action, false);
+            }
+            return;
+        }
+        if (e.type != sf::Event::KeyPressed && e.type != sf::Event::KeyReleased) return;
+
+        bool pressed = (e.type == sf::Event::KeyPressed);
+        for (int action = 0; action < ACTION_PAUSE; action++) {
+            if (bindings[action] == e.key.code && queuedHeld[action] != pressed) {
+                push(action, pressed);
+            }
+        }
+    }
+
+    /// purpose: input for the tick ending at tickEnd. Events stamped up to then apply in order; an action pressed
+    ///          during the tick counts as held for it even if already released. A press waits while the action still
+    ///          reads as down, so at least one tick shows it up and the level sees every tap as a separate edge.
+    PlayerInput nextTick(double tickEnd) {
+        bool pressedDuring[ACTION_COUNT] = { false, false, false, false, false, false };
+        bool releasedDuring[ACTION_COUNT] = { false, false, false, false, false, false };
+        tickedThisFrame = true;
+
+        while (queueCount > 0) {
+            const InputEvent& event = queue[queueHead];
+            if (event.time > tickEnd) break;
+            if (event.pressed && (reported[event.action] || releasedDuring[event.action])) break;
+
+            if (event.pressed) pressedDuring[event.action] = true;
+            else releasedDuring[event.action] = true;
+            held[event.action] = event.pressed;
+            queueHead = (queueHead + 1) % INPUT_QUEUE_CAPACITY;
+            queueCount--;
+        }
+
+        PlayerInput input;
+        input.left = held[ACTION_LEFT] || pressedDuring[ACTION_LEFT];
+        input.right = held[ACTION_RIGHT] || pressedDuring[ACTION_RIGHT];
+        input.up = held[ACTION_UP] || pressedDuring[ACTION_UP];
+        input.down = held[ACTION_DOWN] || pressedDuring[ACTION_DOWN];
+        input.fire = held[ACTION_FIRE] || pressedDuring[ACTION_FIRE];
+        for (int i = 0; i < ACTION_COUNT; i++) {
+            reported[i] = held[i] || pressedDuring[i];
+        }
+        return input;
+    }
+
+    /// purpose: called once per frame; when no tick consumed the queue (menus, pause), events only update what is
+    ///          held, so a key still down when play resumes keeps working and stale taps do not fire.
+    void endFrame() {
+        if (!tickedThisFrame) {
+            while (queueCount > 0) {
+                held[queue[queueHead].action] = queue[queueHead].pressed;
+                queueHead = (queueHead + 1) % INPUT_QUEUE_CAPACITY;
+                queueCount--;
+            }
+            for (int i = 0; i < ACTION_COUNT; i++) {
+                reported[i] = held[i];
+            }
+        }
+        tickedThisFrame = false;
+    }
+};
+
+
+
+
+const unsigned int REPLAY_MAGIC = 0x50525747;
+const unsigned int REPLAY_VERSION = 1;
+
+
+/// purpose: everything besides input that decides how a Level1 session plays out.
+struct ReplaySettings {
+    unsigned int seed;
+    float meteorInterval;
+    float enemyInterval;
+    float playerSpeed;
+    string enemyColor;
+    int waves;
+    int scoreOffset;
+    float startTime;
+    bool timerRunning;
+
+    ReplaySettings() : seed(0), meteorInterval(1.5f), enemyInterval(1.5f), playerSpeed(450.0f), enemyColor("Red"),
+        waves(2), scoreOffset(0), startTime(0.0f), timerRunning(false) {}
+};
+
+
+/// purpose: compact per-tick input log of one Level1 session, with the settings needed to start it again and a
+///          state checksum per tick so playback can name the first tick that went differently.
+/// parameters: inputs take one byte per tick in memory; files store them run-length encoded.
+/// return: saveToFile/loadFromFile report success like SFML's loaders.
+class InputReplay {
+private:
+    ReplaySettings settings;
+    unsigned char* inputs;
+    unsigned int* checksums;
+    long tickCount;
+    long capacity;
+
+    void grow() {
+        long newCapacity = (capacity == 0) ? 4096 : capacity * 2;
+        unsigned char* newInputs = new unsigned char[newCapacity];
+        unsigned int* newChecksums = new unsigned int[newCapacity];
+        for (long i = 0; i < tickCount; i++) {
+            newInputs[i] = inputs[i];
+            newChecksums[i] = checksums[i];
+        }
+        delete[] inputs;
+        delete[] checksums;
+        inputs = newInputs;
+        checksums = newChecksums;
+        capacity = newCapacity;
+    }
+
+    template <typename V>
+    static void writeValue(ofstream& out, const V& value) {
+        out.write((const char*)&value, sizeof(V));
+    }
+
+    template <typename V>
+    static bool readValue(ifstream& in, V& value) {
+        return (bool)in.read((char*)&value, sizeof(V));
+    }
+
+public:
+    InputReplay() : inputs(nullptr), checksums(nullptr), tickCount(0), capacity(0) {}
+
+    ~InputReplay() {
+        delete[] inputs;
+        delete[] checksums;
+    }
+
+    InputReplay(const InputReplay&) = delete;
+    InputReplay& operator=(const InputReplay&) = delete;
+
+    void begin(const ReplaySettings& sessionSettings) {
+        settings = sessionSettings;
+        tickCount = 0;
+    }
+
+    void record(const PlayerInput& input, unsigned int checksum) {
+        if (tickCount == capacity) grow();
+        inputs[tickCount] = input.pack();
+        checksums[tickCount] = checksum;
+        tickCount++;
+    }
+
+    const ReplaySettings& getSettings() const { return settings; }
+    long getTickCount() const { return tickCount; }
+    PlayerInput getInput(long tick) const { return PlayerInput::unpack(inputs[tick]); }
+    unsigned int getChecksum(long tick) const { return checksums[tick]; }
+
+    /// purpose: header, then (input, run length) pairs, then one checksum per tick.
+    bool saveToFile(const string& path) const {
+        ofstream out(path, ios::binary);
+        if (!out) return false;
+
+        writeValue(out, REPLAY_MAGIC);
+        writeValue(out, REPLAY_VERSION);
+        writeValue(out, settings.seed);
+        writeValue(out, settings.meteorInterval);
+        writeValue(out, settings.enemyInterval);
+        writeValue(out, settings.playerSpeed);
+        writeValue(out, settings.waves);
+        writeValue(out, settings.scoreOffset);
+        writeValue(out, settings.startTime);
+        writeValue(out, (unsigned char)(settings.timerRunning ? 1 : 0));
+        writeValue(out, (unsigned char)settings.enemyColor.size());
+        out.write(settings.enemyColor.data(), (streamsize)(unsigned char)settings.enemyColor.size());
+        writeValue(out, (int)tickCount);
+
+        long i = 0;
+        while (i < tickCount) {
+            unsigned short run = 1;
+            while (i + run < tickCount && inputs[i + run] == inputs[i] && run < 65535) run++;
+            writeValue(out, inputs[i]);
+            writeValue(out, run);
+            i += run;
+        }
+        out.write((const char*)checksums, (streamsize)(tickCount * sizeof(unsigned int)));
+        return (bool)out;
+    }
+
+    bool loadFromFile(const string& path) {
+        ifstream in(path, ios::binary);
+        if (!in) return false;
+
+        unsigned int magic = 0, version = 0;
+        if (!readValue(in, magic) || !readValue(in, version) || magic != REPLAY_MAGIC || version != REPLAY_VERSION) {
+            return false;
+        }
+
+        ReplaySettings loaded;
+        unsigned char timerFlag = 0, colorLength = 0;
+        int ticks = 0;
+        if (!readValue(in, loaded.seed) || !readValue(in, loaded.meteorInterval) ||
+            !readValue(in, loaded.enemyInterval) || !readValue(in, loaded.playerSpeed) ||
+            !readValue(in, loaded.waves) || !readValue(in, loaded.scoreOffset) ||
+            !readValue(in, loaded.startTime) || !readValue(in, timerFlag) || !readValue(in, colorLength)) {
+            return false;
+        }
+        loaded.enemyColor.assign(colorLength, ' ');
+        if (colorLength > 0 && !in.read(&loaded.enemyColor[0], colorLength)) return false;
+        if (!readValue(in, ticks) || ticks < 0) return false;
+        loaded.timerRunning = (timerFlag != 0);
+
+        streamoff dataStart = in.tellg();
+        in.seekg(0, ios::end);
+        streamoff remaining = in.tellg() - dataStart;
+        in.seekg(dataStart);
+        if (dataStart < 0 || remaining < 0 || (streamoff)ticks * (streamoff)sizeof(unsigned int) > remaining) {
+            return false;
+        }
+
+        begin(loaded);
+        while (capacity < ticks) grow();
+
+        while (tickCount < ticks) {
+            unsigned char bits = 0;
+            unsigned short run = 0;
+            if (!readValue(in, bits) || !readValue(in, run) || run == 0 || tickCount + run > ticks) {
+                tickCount = 0;
+                return false;
+            }
+            for (unsigned short r = 0; r < run; r++) {
+                inputs[tickCount++] = bits;
+            }
+        }
+        if (!in.read((char*)checksums, (streamsize)(ticks * sizeof(unsigned int)))) {
+            tickCount = 0;
+            return false;
         }
-        activeCount = 0;
+        return true;
+    }
+};
+
+
+
+
+/// purpose: stopwatch driven by simulation dt instead of wall time, so gameplay timers behave the same on screen and headless.
+/// parameters: advance is fed the tick dt by the owner.
+/// return: restart returns the elapsed seconds before resetting, like sf::Clock.
+class SimClock {
+private:
+    float elapsed;
+
+public:
+    SimClock() : elapsed(0.0f) {}
+
+    void advance(float dt) {
+        elapsed += dt;
+    }
+
+    float restart() {
+        float e = elapsed;
+        elapsed = 0.0f;
+        return e;
+    }
+
+    float getElapsedSeconds() const {
+        return elapsed;
+    }
+};
+
+
+
+
+/// purpose: returns the pixel size of gameplay textures without decoding them, for headless bounds and collisions.
+/// parameters: path is the asset file name as passed to loadFromFile.
+/// return: true and fills size when the asset is known.
+bool headlessFootprint(const string& path, sf::Vector2u& size) {
+    struct Footprint { const char* path; unsigned int w; unsigned int h; };
+    static const Footprint footprints[] = {
+        { "playerShip1_red.png", 99, 75 },
+        { "playerShip1_blue.png", 99, 75 },
+        { "playerShip1_green.png", 99, 75 },
+        { "playerShip1_orange.png", 99, 75 },
+        { "playerShip1_damage3.png", 100, 76 },
+        { "playerShip2_damage1.png", 111, 76 },
+        { "meteorBrown_big1.png", 101, 84 },
+        { "meteorBrown_small1.png", 28, 28 },
+        { "laserRed02.png", 13, 37 },
+        { "enemyRed1.png", 93, 84 },
+        { "enemyBlue1.png", 93, 84 },
+        { "enemyGreen1.png", 93, 84 },
+        { "enemyBlack1.png", 93, 84 },
+        { "boss_blue.png", 549, 455 },
+        { "powerupRed_bolt.png", 34, 33 },
+        { "powerupGreen_shield.png", 34, 33 },
+        { "pill_blue.png", 22, 21 },
+        { "bolt_gold.png", 19, 30 },
+        { "shield3.png", 144, 137 }
+    };
+
+    for (const Footprint& f : footprints) {
+        if (path == f.path) {
+            size = sf::Vector2u(f.w, f.h);
+            return true;
+        }
+    }
+    return false;
+}
+
+
+
+
+/// purpose: one decoded texture shared by every handle that asked for the same path.
+/// parameters: atlas regions point at their page entry and only own a sub-rectangle of it.
+struct CachedTexture {
+    string path;
+    sf::Texture texture;
+    sf::IntRect rect;
+    CachedTexture* page;
+    int refCount;
+
+    CachedTexture() : page(nullptr), refCount(0) {}
+
+    const sf::Texture& source() const {
+        return page != nullptr ? page->texture : texture;
+    }
+};
+
+
+/// purpose: where a packed image lives, as listed in atlas.txt by the atlas_packer tool.
+struct AtlasRegion {
+    string page;
+    sf::IntRect rect;
+};
+
+
+/// purpose: reference-counted texture cache keyed by file path, so each png is decoded and uploaded once.
+///          One lock guards the table, so headless levels can be built on worker threads.
+/// parameters: acquire loads on first use, uploading AssetLoader's decoded image when it has one (headless keeps
+///             only the footprint); release frees on the last reference.
+/// return: acquire returns nullptr when the file cannot be loaded.
+class TextureCache {
+private:
+    map<string, CachedTexture*> entries;
+    map<string, AtlasRegion> atlasRegions;
+    int loadCount;
+    recursive_mutex entriesLock;
+
+    TextureCache() : loadCount(0) {
+        loadAtlasTable("atlas.txt");
+    }
+
+    /// purpose: read the packer's metadata; without it every image is loaded from its own file as before.
+    void loadAtlasTable(const string& tablePath) {
+        const char* data = nullptr;
+        size_t size = 0;
+        if (AssetPack::shared().find(tablePath, data, size)) {
+            istringstream packed(string(data, size));
+            readAtlasTable(packed);
+            return;
+        }
+
+        ifstream table(tablePath);
+        if (!table.is_open()) return;
+        readAtlasTable(table);
+    }
+
+    void readAtlasTable(istream& table) {
+        string line;
+        while (getline(table, line)) {
+            if (line.empty() || line[0] == '#') continue;
+
+            istringstream fields(line);
+            string name;
+            AtlasRegion region;
+            if (fields >> name >> region.page >> region.rect.left >> region.rect.top >> region.rect.width >> region.rect.height) {
+                atlasRegions[name] = region;
+            }
+        }
+    }
+
+public:
+    ~TextureCache() {
+        for (auto& e : entries) {
+            delete e.second;
+        }
+    }
+
+    static TextureCache& instance() {
+        static TextureCache cache;
+        return cache;
+    }
+
+    CachedTexture* acquire(const string& path) {
+        lock_guard<recursive_mutex> guard(entriesLock);
+        auto it = entries.find(path);
+        if (it != entries.end()) {
+            it->second->refCount++;
+            return it->second;
+        }
+
+        CachedTexture* entry = new CachedTexture();
+        entry->path = path;
+
+
+        auto region = atlasRegions.find(path);
+        if (region != atlasRegions.end()) {
+            if (!headlessMode) {
+                entry->page = acquire(region->second.page);
+                if (entry->page == nullptr) {
+                    delete entry;
+                    return nullptr;
+                }
+            }
+            entry->rect = region->second.rect;
+            entry->refCount = 1;
+            entries[path] = entry;
+            return entry;
+        }
+
+        sf::Vector2u size;
+        if (headlessMode) {
+            if (!headlessFootprint(path, size)) {
+                delete entry;
+                return nullptr;
+            }
+        }
+        else {
+            const sf::Image* decoded = AssetLoader::shared().findImage(path);
+            sf::Image image;
+            bool loaded = false;
+            if (decoded != nullptr) {
+                loaded = entry->texture.loadFromImage(*decoded);
+            }
+            else if (PixelCache::shared().decode(path, image)) {
+                loaded = entry->texture.loadFromImage(image);
+            }
+            if (!loaded) {
+                delete entry;
+                return nullptr;
+            }
+            size = entry->texture.getSize();
+        }
+        entry->rect = sf::IntRect(0, 0, (int)size.x, (int)size.y);
+        entry->refCount = 1;
+        entries[path] = entry;
+        loadCount++;
+        return entry;
+    }
+
+    /// purpose: take one more reference to an entry already held (handle copies).
+    void retain(CachedTexture* entry) {
+        if (entry == nullptr) return;
+
+        lock_guard<recursive_mutex> guard(entriesLock);
+        entry->refCount++;
+    }
+
+    void release(CachedTexture* entry) {
+        if (entry == nullptr) return;
+
+        lock_guard<recursive_mutex> guard(entriesLock);
+        entry->refCount--;
+        if (entry->refCount <= 0) {
+            entries.erase(entry->path);
+            release(entry->page);
+            delete entry;
+        }
+    }
+
+    /// return: the file acquire(path) actually reads, i.e. the atlas page for packed images.
+    string sourceFileFor(const string& path) {
+        lock_guard<recursive_mutex> guard(entriesLock);
+        auto region = atlasRegions.find(path);
+        return (region != atlasRegions.end()) ? region->second.page : path;
+    }
+
+    /// return: bytes of texture memory held right now; packed images count once, through their atlas page.
+    size_t getResidentBytes() {
+        lock_guard<recursive_mutex> guard(entriesLock);
+        size_t bytes = 0;
+        for (auto& e : entries) {
+            if (e.second->page == nullptr) {
+                bytes += (size_t)e.second->rect.width * (size_t)e.second->rect.height * 4;
+            }
+        }
+        return bytes;
+    }
+
+    int getResidentCount() const { return (int)entries.size(); }
+    int getAtlasRegionCount() const { return (int)atlasRegions.size(); }
+    int getLoadCount() const { return loadCount; }
+};
+
+
+/// purpose: handle into the texture cache; copies share the same texture and the last one out releases it.
+/// parameters: loadFromFile mirrors sf::Texture so members can switch over without touching call sites.
+/// return: applyTo binds texture and footprint to a sprite, which also works headless.
+class TextureHandle {
+private:
+    CachedTexture* entry;
+
+public:
+    TextureHandle() : entry(nullptr) {}
+
+    TextureHandle(const TextureHandle& other) : entry(other.entry) {
+        TextureCache::instance().retain(entry);
+    }
+
+    TextureHandle& operator=(const TextureHandle& other) {
+        if (this != &other) {
+            TextureCache::instance().retain(other.entry);
+            TextureCache::instance().release(entry);
+            entry = other.entry;
+        }
+        return *this;
+    }
+
+    ~TextureHandle() {
+        TextureCache::instance().release(entry);
+    }
+
+    bool loadFromFile(const string& path) {
+        if (entry != nullptr && entry->path == path) return true;
+
+        CachedTexture* loaded = TextureCache::instance().acquire(path);
+        if (loaded == nullptr) return false;
+
+        TextureCache::instance().release(entry);
+        entry = loaded;
+        return true;
+    }
+
+    void applyTo(sf::Sprite& sprite) const {
+        sprite.setTexture(get());
+        sprite.setTextureRect(entry != nullptr ? entry->rect : sf::IntRect());
+    }
+
+    const sf::Texture& get() const {
+        static const sf::Texture empty;
+        return entry != nullptr ? entry->source() : empty;
+    }
+
+    sf::Vector2u getSize() const {
+        if (entry == nullptr) return sf::Vector2u(0, 0);
+        return sf::Vector2u((unsigned int)entry->rect.width, (unsigned int)entry->rect.height);
+    }
+
+    bool isLoaded() const {
+        return entry != nullptr;
+    }
+};
+
+
+
+
+/// purpose: render states that draw an entity between its previous and current simulated position.
+/// parameters: alpha is the fraction of a simulation tick elapsed since the last step (0..1).
+/// return: a translation applied on top of the sprite's own transform.
+sf::RenderStates interpolatedStates(const sf::Vector2f& previous, const sf::Vector2f& current, float alpha) {
+    sf::Transform offset;
+    offset.translate((previous.x - current.x) * (1.0f - alpha), (previous.y - current.y) * (1.0f - alpha));
+    return sf::RenderStates(offset);
+}
+
+
+
+
+#ifdef GALAXY_PROFILER
+
+const int PROFILE_FRAME = 0;
+const int PROFILE_LEVEL_UPDATE = 1;
+const int PROFILE_SPAWN = 2;
+const int PROFILE_METEORS = 3;
+const int PROFILE_ENEMIES = 4;
+const int PROFILE_COLLISIONS = 5;
+const int PROFILE_LEVEL_DRAW = 6;
+const int PROFILE_ZONES = 7;
+const char* const PROFILE_ZONE_NAMES[PROFILE_ZONES] = {
+    "frame", "level update", "spawning", "meteors", "enemies", "collisions", "level draw"
+};
+
+const unsigned int PROFILE_RING_SIZE = 4096;
+const int PROFILE_RINGS = 4;
+const int PROFILE_WINDOW = 120;
+const int PROFILE_BUCKETS = 40;
+const float PROFILE_BUCKET_MS = 0.5f;
+
+
+struct ProfileSample {
+    int zone;
+    float ms;
+};
+
+
+/// purpose: single-producer/single-consumer lock-free ring of samples. The producer is whichever thread has
+///          claimed it; a ring handed back keeps its head and tail, so the next owner carries on where it stopped.
+struct ProfileRing {
+    ProfileSample samples[PROFILE_RING_SIZE];
+    std::atomic<unsigned int> head;
+    std::atomic<unsigned int> tail;
+    std::atomic<unsigned int> dropped;
+    std::atomic<bool> claimed;
+
+    ProfileRing() : head(0), tail(0), dropped(0), claimed(false) {}
+};
+
+
+/// purpose: a thread's hold on one ring; it is handed back when the thread exits.
+struct ProfileRingClaim {
+    ProfileRing* ring;
+
+    ProfileRingClaim() : ring(nullptr) {}
+
+    ~ProfileRingClaim() {
+        if (ring != nullptr) ring->claimed.store(false, std::memory_order_release);
+    }
+};
+
+
+/// purpose: collects zone timings through one lock-free ring per recording thread, folds them into per-frame
+///          totals at endFrame(), and keeps rolling windows (avg, p99) plus session histograms.
+///          Only threads that called registerThread() record (the main thread and the simulation thread); zones
+///          on any other thread are ignored. Samples count toward the frame whose endFrame() drains them.
+/// parameters: build with -DGALAXY_PROFILER; without it every PROFILE_* / PROFILER_* macro expands to nothing.
+class FrameProfiler {
+private:
+    ProfileRing rings[PROFILE_RINGS];
+
+    float frameTotals[PROFILE_ZONES];
+    float window[PROFILE_ZONES][PROFILE_WINDOW];
+    int windowCount;
+    int windowPos;
+
+    long long sessionFrames;
+    double sessionSum[PROFILE_ZONES];
+    float sessionMax[PROFILE_ZONES];
+    int histogram[PROFILE_ZONES][PROFILE_BUCKETS];
+
+    bool overlayVisible;
+    bool fontLoaded;
+    sf::Font font;
+    sf::Text text;
+    sf::VertexArray bars;
+
+    FrameProfiler() : windowCount(0), windowPos(0), sessionFrames(0), overlayVisible(false), fontLoaded(false), bars(sf::Triangles) {
+        for (int z = 0; z < PROFILE_ZONES; z++) {
+            frameTotals[z] = 0.0f;
+            sessionSum[z] = 0.0;
+            sessionMax[z] = 0.0f;
+            for (int b = 0; b < PROFILE_BUCKETS; b++) {
+                histogram[z][b] = 0;
+            }
+        }
+    }
+
+    static ProfileRingClaim& threadClaim() {
+        thread_local ProfileRingClaim claim;
+        return claim;
+    }
+
+    static int bucketFor(float ms) {
+        int b = (int)(ms / PROFILE_BUCKET_MS);
+        return b < PROFILE_BUCKETS ? b : PROFILE_BUCKETS - 1;
+    }
+
+public:
+    static FrameProfiler& instance() {
+        static FrameProfiler profiler;
+        return profiler;
+    }
+
+    /// purpose: give the calling thread a free ring until it exits; does nothing if it already has one.
+    void registerThread() {
+        ProfileRingClaim& claim = threadClaim();
+        if (claim.ring != nullptr) return;
+
+        for (ProfileRing& ring : rings) {
+            bool expected = false;
+            if (ring.claimed.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                claim.ring = &ring;
+                return;
+            }
+        }
+        cout << "WARNING: all " << PROFILE_RINGS << " profiler rings are taken; this thread is not profiled" << endl;
+    }
+
+    /// purpose: producer side; never blocks, drops the sample if the consumer has fallen a full ring behind.
+    void record(int zone, float ms) {
+        ProfileRing* claimed = threadClaim().ring;
+        if (claimed == nullptr) return;
+
+        ProfileRing& ring = *claimed;
+        unsigned int h = ring.head.load(std::memory_order_relaxed);
+        if (h - ring.tail.load(std::memory_order_acquire) >= PROFILE_RING_SIZE) {
+            ring.dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        ring.samples[h & (PROFILE_RING_SIZE - 1)] = { zone, ms };
+        ring.head.store(h + 1, std::memory_order_release);
+    }
+
+    /// purpose: consumer side; drain every ring and close the frame (zones entered several times are summed).
+    void endFrame() {
+        for (ProfileRing& ring : rings) {
+            unsigned int t = ring.tail.load(std::memory_order_relaxed);
+            unsigned int h = ring.head.load(std::memory_order_acquire);
+            for (; t != h; t++) {
+                const ProfileSample& sample = ring.samples[t & (PROFILE_RING_SIZE - 1)];
+                frameTotals[sample.zone] += sample.ms;
+            }
+            ring.tail.store(t, std::memory_order_release);
+        }
+
+        for (int z = 0; z < PROFILE_ZONES; z++) {
+            float ms = frameTotals[z];
+            window[z][windowPos] = ms;
+            sessionSum[z] += ms;
+            if (ms > sessionMax[z]) sessionMax[z] = ms;
+            histogram[z][bucketFor(ms)]++;
+            frameTotals[z] = 0.0f;
+        }
+        windowPos = (windowPos + 1) % PROFILE_WINDOW;
+        if (windowCount < PROFILE_WINDOW) windowCount++;
+        sessionFrames++;
+    }
+
+    float average(int zone) const {
+        if (windowCount == 0) return 0.0f;
+        float sum = 0.0f;
+        for (int i = 0; i < windowCount; i++) {
+            sum += window[zone][i];
+        }
+        return sum / windowCount;
+    }
+
+    float percentile99(int zone) const {
+        if (windowCount == 0) return 0.0f;
+        float sorted[PROFILE_WINDOW];
+        for (int i = 0; i < windowCount; i++) {
+            sorted[i] = window[zone][i];
+        }
+        int rank = (int)std::ceil(0.99f * windowCount) - 1;
+        std::nth_element(sorted, sorted + rank, sorted + windowCount);
+        return sorted[rank];
+    }
+
+    void toggleOverlay() {
+        overlayVisible = !overlayVisible;
+    }
+
+    /// purpose: per-zone rolling avg/p99 text plus a session histogram of frame times (0.5 ms buckets).
+    void drawOverlay(sf::RenderTarget& target) {
+        if (!overlayVisible) return;
+        if (!fontLoaded) {
+            fontLoaded = loadFontAsset(font, "arial.ttf");
+            if (!fontLoaded) return;
+            text.setFont(font);
+            text.setCharacterSize(18);
+            text.setFillColor(sf::Color::White);
+        }
+
+        ostringstream lines;
+        lines << fixed << setprecision(2);
+        for (int z = 0; z < PROFILE_ZONES; z++) {
+            lines << PROFILE_ZONE_NAMES[z] << ": avg " << average(z) << " ms  p99 " << percentile99(z) << " ms\n";
+        }
+        unsigned int dropped = 0;
+        for (const ProfileRing& ring : rings) {
+            dropped += ring.dropped.load(std::memory_order_relaxed);
+        }
+        if (dropped > 0) lines << "dropped samples: " << dropped << "\n";
+
+        sf::RectangleShape panel(sf::Vector2f(420.0f, 320.0f));
+        panel.setPosition(10.0f, 110.0f);
+        panel.setFillColor(sf::Color(0, 0, 0, 170));
+        target.draw(panel);
+
+        text.setString(lines.str());
+        text.setPosition(20.0f, 120.0f);
+        target.draw(text);
+
+
+        int tallest = 1;
+        for (int b = 0; b < PROFILE_BUCKETS; b++) {
+            if (histogram[PROFILE_FRAME][b] > tallest) tallest = histogram[PROFILE_FRAME][b];
+        }
+        bars.clear();
+        float baseY = 420.0f;
+        for (int b = 0; b < PROFILE_BUCKETS; b++) {
+            float h = 90.0f * histogram[PROFILE_FRAME][b] / tallest;
+            float x = 20.0f + b * 10.0f;
+            sf::Color color = (b * PROFILE_BUCKET_MS < 16.7f) ? sf::Color(80, 220, 120) : sf::Color(230, 80, 60);
+            bars.append(sf::Vertex(sf::Vector2f(x, baseY - h), color));
+            bars.append(sf::Vertex(sf::Vector2f(x + 8.0f, baseY - h), color));
+            bars.append(sf::Vertex(sf::Vector2f(x + 8.0f, baseY), color));
+            bars.append(sf::Vertex(sf::Vector2f(x, baseY - h), color));
+            bars.append(sf::Vertex(sf::Vector2f(x + 8.0f, baseY), color));
+            bars.append(sf::Vertex(sf::Vector2f(x, baseY), color));
+        }
+        target.draw(bars);
+    }
+
+    /// purpose: write the session summary (avg/p99/max per zone) and the per-zone histograms.
+    bool exportCsv(const string& path) const {
+        ofstream file(path);
+        if (!file.is_open()) return false;
+
+        file << "zone,frames,avg_ms,max_ms,p99_ms_session" << endl;
+        for (int z = 0; z < PROFILE_ZONES; z++) {
+            long long target = (long long)std::ceil(0.99 * sessionFrames);
+            long long seen = 0;
+            int p99Bucket = PROFILE_BUCKETS - 1;
+            for (int b = 0; b < PROFILE_BUCKETS; b++) {
+                seen += histogram[z][b];
+                if (seen >= target) {
+                    p99Bucket = b;
+                    break;
+                }
+            }
+            double avg = sessionFrames > 0 ? sessionSum[z] / sessionFrames : 0.0;
+            file << PROFILE_ZONE_NAMES[z] << "," << sessionFrames << "," << avg << "," << sessionMax[z] << ","
+                << (p99Bucket + 1) * PROFILE_BUCKET_MS << endl;
+        }
+
+        file << endl << "zone,bucket_start_ms,frames" << endl;
+        for (int z = 0; z < PROFILE_ZONES; z++) {
+            for (int b = 0; b < PROFILE_BUCKETS; b++) {
+                if (histogram[z][b] == 0) continue;
+                file << PROFILE_ZONE_NAMES[z] << "," << b * PROFILE_BUCKET_MS << "," << histogram[z][b] << endl;
+            }
+        }
+        return true;
+    }
+};
+
+
+/// purpose: RAII timer; records the enclosing scope's duration under one zone.
+class ProfileZone {
+private:
+    int zone;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    ProfileZone(int zoneId) : zone(zoneId), start(std::chrono::steady_clock::now()) {}
+
+    ~ProfileZone() {
+        std::chrono::duration<float, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        FrameProfiler::instance().record(zone, elapsed.count());
+    }
+};
+
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(zone) ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(zone)
+#define PROFILER_END_FRAME() FrameProfiler::instance().endFrame()
+#define PROFILER_REGISTER_THREAD() FrameProfiler::instance().registerThread()
+#define PROFILER_TOGGLE_OVERLAY() FrameProfiler::instance().toggleOverlay()
+#define PROFILER_DRAW_OVERLAY(target) FrameProfiler::instance().drawOverlay(target)
+#define PROFILER_EXPORT_CSV(path) FrameProfiler::instance().exportCsv(path)
+
+#else
+
+#define PROFILE_ZONE(zone)
+#define PROFILER_END_FRAME()
+#define PROFILER_REGISTER_THREAD()
+#define PROFILER_TOGGLE_OVERLAY()
+#define PROFILER_DRAW_OVERLAY(target)
+#define PROFILER_EXPORT_CSV(path)
+
+#endif
+
+
+
+
+int drawCallsThisFrame = 0;
+
+
+/// purpose: draw and count; level rendering goes through here so the per-frame draw-call counter is accurate.
+void countedDraw(sf::RenderTarget& target, const sf::Drawable& drawable, const sf::RenderStates& states = sf::RenderStates::Default) {
+    target.draw(drawable, states);
+    drawCallsThisFrame++;
+}
+
+
+
+
+/// enough for the Level1 HUD without an atlas (ten numerals, two icons and flat shapes), which is never flushed mid-build.
+const int SPRITE_BATCH_TEXTURES = 16;
+/// one per texture and flush of a level frame, with room to spare (a level uses about twenty).
+const int SNAPSHOT_LAYERS = 64;
+
+
+/// purpose: one draw call kept by a level snapshot; from holds the vertices at the previous tick, to at the latest.
+struct SnapshotLayer {
+    const sf::Texture* texture;
+    sf::VertexArray from;
+    sf::VertexArray to;
+
+    SnapshotLayer() : texture(nullptr), from(sf::Triangles), to(sf::Triangles) {}
+};
+
+
+/// purpose: collects sprites and flat shapes as triangles, one vertex array per texture, and submits each array
+///          in a single draw call on flush(). Call begin/flush around every layer to keep the layer order.
+class SpriteBatch {
+private:
+    const sf::Texture* textures[SPRITE_BATCH_TEXTURES];
+    sf::VertexArray vertices[SPRITE_BATCH_TEXTURES];
+    int textureCount;
+    sf::RenderTarget* target;
+    SnapshotLayer* recordLayers;
+    int* recordCount;
+    bool recordLatest;
+
+    sf::VertexArray& bucketFor(const sf::Texture* texture) {
+        for (int i = 0; i < textureCount; i++) {
+            if (textures[i] == texture) return vertices[i];
+        }
+        if (textureCount == SPRITE_BATCH_TEXTURES) {
+            flush();
+        }
+        textures[textureCount] = texture;
+        return vertices[textureCount++];
+    }
+
+    static void appendTriangle(sf::VertexArray& array, const sf::Vertex& a, const sf::Vertex& b, const sf::Vertex& c) {
+        array.append(a);
+        array.append(b);
+        array.append(c);
+    }
+
+public:
+    SpriteBatch() : textureCount(0), target(nullptr), recordLayers(nullptr), recordCount(nullptr), recordLatest(false) {
+        for (int i = 0; i < SPRITE_BATCH_TEXTURES; i++) {
+            textures[i] = nullptr;
+            vertices[i].setPrimitiveType(sf::Triangles);
+        }
+    }
+
+    void begin(sf::RenderTarget& renderTarget) {
+        target = &renderTarget;
+        recordLayers = nullptr;
+        textureCount = 0;
+    }
+
+    /// purpose: snapshot use; flush() appends one layer per texture to layers instead of drawing. A frame recorded
+    ///          twice, at alpha 0 into from and at alpha 1 into to, lines up layer by layer.
+    void beginRecording(SnapshotLayer* layers, int& layerCount, bool latest) {
+        target = nullptr;
+        recordLayers = layers;
+        recordCount = &layerCount;
+        recordLatest = latest;
+        textureCount = 0;
+    }
+
+    /// parameters: offset is applied on top of the sprite's own transform (e.g. interpolatedStates(...).transform).
+    void add(const sf::Sprite& sprite, const sf::Transform& offset = sf::Transform::Identity) {
+        const sf::Texture* texture = sprite.getTexture();
+        if (texture == nullptr) return;
+
+        sf::IntRect rect = sprite.getTextureRect();
+        float w = (float)std::abs(rect.width);
+        float h = (float)std::abs(rect.height);
+        float left = (float)rect.left;
+        float top = (float)rect.top;
+        float right = left + rect.width;
+        float bottom = top + rect.height;
+
+        sf::Transform transform = offset * sprite.getTransform();
+        sf::Color color = sprite.getColor();
+        sf::Vertex topLeft(transform.transformPoint(0.0f, 0.0f), color, sf::Vector2f(left, top));
+        sf::Vertex topRight(transform.transformPoint(w, 0.0f), color, sf::Vector2f(right, top));
+        sf::Vertex bottomRight(transform.transformPoint(w, h), color, sf::Vector2f(right, bottom));
+        sf::Vertex bottomLeft(transform.transformPoint(0.0f, h), color, sf::Vector2f(left, bottom));
+
+        sf::VertexArray& array = bucketFor(texture);
+        appendTriangle(array, topLeft, topRight, bottomRight);
+        appendTriangle(array, topLeft, bottomRight, bottomLeft);
+    }
+
+    void addRect(const sf::FloatRect& rect, const sf::Color& color) {
+        sf::Vertex topLeft(sf::Vector2f(rect.left, rect.top), color);
+        sf::Vertex topRight(sf::Vector2f(rect.left + rect.width, rect.top), color);
+        sf::Vertex bottomRight(sf::Vector2f(rect.left + rect.width, rect.top + rect.height), color);
+        sf::Vertex bottomLeft(sf::Vector2f(rect.left, rect.top + rect.height), color);
+
+        sf::VertexArray& array = bucketFor(nullptr);
+        appendTriangle(array, topLeft, topRight, bottomRight);
+        appendTriangle(array, topLeft, bottomRight, bottomLeft);
+    }
+
+    /// purpose: rectangle with an outline drawn outside it, like sf::RectangleShape::setOutlineThickness.
+    void addOutlinedRect(const sf::FloatRect& rect, const sf::Color& fill, float thickness, const sf::Color& outline) {
+        float t = thickness;
+        addRect(sf::FloatRect(rect.left - t, rect.top - t, rect.width + 2.0f * t, t), outline);
+        addRect(sf::FloatRect(rect.left - t, rect.top + rect.height, rect.width + 2.0f * t, t), outline);
+        addRect(sf::FloatRect(rect.left - t, rect.top, t, rect.height), outline);
+        addRect(sf::FloatRect(rect.left + rect.width, rect.top, t, rect.height), outline);
+        addRect(rect, fill);
+    }
+
+    void addCircle(const sf::Vector2f& center, float radius, const sf::Color& color, int points = 16) {
+        sf::VertexArray& array = bucketFor(nullptr);
+        sf::Vertex middle(center, color);
+        for (int i = 0; i < points; i++) {
+            float a0 = i * 2.0f * 3.14159265f / points;
+            float a1 = (i + 1) * 2.0f * 3.14159265f / points;
+            appendTriangle(array, middle,
+                sf::Vertex(sf::Vector2f(center.x + std::cos(a0) * radius, center.y + std::sin(a0) * radius), color),
+                sf::Vertex(sf::Vector2f(center.x + std::cos(a1) * radius, center.y + std::sin(a1) * radius), color));
+        }
+    }
+
+    /// purpose: retained use; drop everything added so far without drawing it.
+    void clear() {
+        for (int i = 0; i < textureCount; i++) {
+            vertices[i].clear();
+        }
+        textureCount = 0;
+    }
+
+    /// purpose: retained use; draw what was added since clear() and keep it for the next submit.
+    void submit(sf::RenderTarget& renderTarget) const {
+        for (int i = 0; i < textureCount; i++) {
+            if (vertices[i].getVertexCount() > 0) {
+                sf::RenderStates states;
+                states.texture = textures[i];
+                countedDraw(renderTarget, vertices[i], states);
+            }
+        }
+    }
+
+    /// purpose: submit one draw call per texture used since begin() (or record it, see beginRecording); vertex
+    ///          storage is kept for the next frame.
+    void flush() {
+        for (int i = 0; i < textureCount; i++) {
+            if (recordLayers != nullptr) {
+                if (vertices[i].getVertexCount() > 0 && *recordCount < SNAPSHOT_LAYERS) {
+                    SnapshotLayer& layer = recordLayers[(*recordCount)++];
+                    layer.texture = textures[i];
+                    (recordLatest ? layer.to : layer.from) = vertices[i];
+                }
+                vertices[i].clear();
+            }
+            else if (vertices[i].getVertexCount() > 0) {
+                sf::RenderStates states;
+                states.texture = textures[i];
+                countedDraw(*target, vertices[i], states);
+                vertices[i].clear();
+            }
+        }
+        textureCount = 0;
     }
 };
 
@@ -1424,7 +3543,8 @@ public:
 class PowerUp {
 private:
     sf::Sprite sprite;
-    sf::Texture textures[4];
+    sf::Vector2f previousPosition;
+    TextureHandle textures[4];
     int type;
     bool active;
     float speed;
@@ -1449,13 +3569,18 @@ public:
     void spawn(float x, int powerType) {
         active = true;
         type = powerType;
-        sprite.setTexture(textures[type]);
+        textures[type].applyTo(sprite);
 
 
         sf::FloatRect bounds = sprite.getLocalBounds();
         sprite.setOrigin(bounds.width / 2.0f, bounds.height / 2.0f);
 
         sprite.setPosition(x, -50.0f);
+        previousPosition = sprite.getPosition();
+    }
+
+    void storePreviousPosition() {
+        previousPosition = sprite.getPosition();
     }
 
     void update(float dt) {
@@ -1468,8 +3593,8 @@ public:
         }
     }
 
-    void draw(sf::RenderWindow& window) {
-        if (active) window.draw(sprite);
+    void draw(SpriteBatch& batch, float alpha = 1.0f) {
+        if (active) batch.add(sprite, interpolatedStates(previousPosition, sprite.getPosition(), alpha).transform);
     }
 
     bool isActive() const { return active; }
@@ -1481,64 +3606,307 @@ public:
 
 
 
-class EnemyBullet {
+const unsigned char PROJECTILE_ACTIVE = 1;
+const unsigned char PROJECTILE_EXPLODING = 2;
+const int PROJECTILE_KINDS = 4;
+
+
+/// purpose: structure-of-arrays storage for bullets and meteors. Live entries are packed at the front so the
+///          movement kernel streams through plain float arrays; sprites are only assembled when drawing.
+/// parameters: maxCount is the hard cap; kinds select one of up to PROJECTILE_KINDS textures per entry.
+class ProjectileField {
 private:
-    sf::Sprite sprite;
-    sf::Texture texture;
-    float speed;
-    bool active;
-    int screenHeight;
+    float* x;
+    float* y;
+    float* previousX;
+    float* previousY;
+    float* vx;
+    float* vy;
+    float* rotation;
+    float* spin;
+    float* timer;
+    int* kind;
+    unsigned char* flags;
+    int capacity;
+    int count;
 
-public:
-    EnemyBullet() : speed(300.0f), active(false), screenHeight(1080) {}
+    float cullMinX, cullMinY, cullMaxX, cullMaxY;
 
-    bool loadTexture(const string& texturePath) {
-        if (texture.loadFromFile(texturePath)) {
-            sprite.setTexture(texture);
-            sf::FloatRect bounds = sprite.getLocalBounds();
-            sprite.setOrigin(bounds.width / 2.0f, bounds.height / 2.0f);
-            return true;
+    TextureHandle textures[PROJECTILE_KINDS];
+    sf::Sprite sprites[PROJECTILE_KINDS];
+    float halfWidth[PROJECTILE_KINDS];
+    float halfHeight[PROJECTILE_KINDS];
+
+    void moveEntry(int from, int to) {
+        x[to] = x[from];
+        y[to] = y[from];
+        previousX[to] = previousX[from];
+        previousY[to] = previousY[from];
+        vx[to] = vx[from];
+        vy[to] = vy[from];
+        rotation[to] = rotation[from];
+        spin[to] = spin[from];
+        timer[to] = timer[from];
+        kind[to] = kind[from];
+        flags[to] = flags[from];
+    }
+
+    template <typename V>
+    void growArray(V*& array, int newCapacity) {
+        V* grown = new V[newCapacity];
+        for (int i = 0; i < count; i++) {
+            grown[i] = array[i];
         }
-        return false;
+        delete[] array;
+        array = grown;
     }
 
-    void setScreenHeight(int height) {
-        screenHeight = height;
+public:
+    ProjectileField(int maxCount) : capacity(maxCount), count(0) {
+        x = new float[capacity];
+        y = new float[capacity];
+        previousX = new float[capacity];
+        previousY = new float[capacity];
+        vx = new float[capacity];
+        vy = new float[capacity];
+        rotation = new float[capacity];
+        spin = new float[capacity];
+        timer = new float[capacity];
+        kind = new int[capacity];
+        flags = new unsigned char[capacity];
+
+        cullMinX = cullMinY = -1.0e30f;
+        cullMaxX = cullMaxY = 1.0e30f;
+        for (int k = 0; k < PROJECTILE_KINDS; k++) {
+            halfWidth[k] = 0.0f;
+            halfHeight[k] = 0.0f;
+        }
+    }
+
+    ~ProjectileField() {
+        delete[] x;
+        delete[] y;
+        delete[] previousX;
+        delete[] previousY;
+        delete[] vx;
+        delete[] vy;
+        delete[] rotation;
+        delete[] spin;
+        delete[] timer;
+        delete[] kind;
+        delete[] flags;
+    }
+
+    bool setTexture(int k, const string& texturePath) {
+        if (k < 0 || k >= PROJECTILE_KINDS) return false;
+        if (!textures[k].loadFromFile(texturePath)) return false;
+
+        textures[k].applyTo(sprites[k]);
+        sf::FloatRect bounds = sprites[k].getLocalBounds();
+        sprites[k].setOrigin(bounds.width / 2.0f, bounds.height / 2.0f);
+        halfWidth[k] = bounds.width / 2.0f;
+        halfHeight[k] = bounds.height / 2.0f;
+        return true;
     }
 
-    void fire(float x, float y) {
-        active = true;
-        sprite.setPosition(x, y);
+    /// purpose: grow the arrays to hold at least newCapacity entries; live entries are kept, the field never shrinks.
+    void reserve(int newCapacity) {
+        if (newCapacity <= capacity) return;
+
+        growArray(x, newCapacity);
+        growArray(y, newCapacity);
+        growArray(previousX, newCapacity);
+        growArray(previousY, newCapacity);
+        growArray(vx, newCapacity);
+        growArray(vy, newCapacity);
+        growArray(rotation, newCapacity);
+        growArray(spin, newCapacity);
+        growArray(timer, newCapacity);
+        growArray(kind, newCapacity);
+        growArray(flags, newCapacity);
+        capacity = newCapacity;
+    }
+
+    /// purpose: entries whose position leaves this box are switched off by integrate().
+    void setCullBox(float minX, float minY, float maxX, float maxY) {
+        cullMinX = minX;
+        cullMinY = minY;
+        cullMaxX = maxX;
+        cullMaxY = maxY;
+    }
+
+    /// parameters: velocity in px/s, rotation in degrees, spinRate in degrees/s.
+    /// return: index of the new entry, or -1 when the field is full.
+    int spawn(float px, float py, float velX, float velY, float rotationDegrees = 0.0f, float spinRate = 0.0f, int k = 0) {
+        if (count == capacity) return -1;
+
+        int i = count++;
+        x[i] = px;
+        y[i] = py;
+        previousX[i] = px;
+        previousY[i] = py;
+        vx[i] = velX;
+        vy[i] = velY;
+        rotation[i] = rotationDegrees;
+        spin[i] = spinRate;
+        timer[i] = 0.0f;
+        kind[i] = k;
+        flags[i] = PROJECTILE_ACTIVE;
+        return i;
+    }
+
+    /// purpose: advance every entry by dt and switch off the ones outside the cull box.
+    void integrate(float dt) {
+        int i = 0;
+
+#if defined(__AVX__)
+        __m256 dt8 = _mm256_set1_ps(dt);
+        __m256 minX8 = _mm256_set1_ps(cullMinX);
+        __m256 minY8 = _mm256_set1_ps(cullMinY);
+        __m256 maxX8 = _mm256_set1_ps(cullMaxX);
+        __m256 maxY8 = _mm256_set1_ps(cullMaxY);
+        for (; i + 8 <= count; i += 8) {
+            __m256 px = _mm256_add_ps(_mm256_loadu_ps(x + i), _mm256_mul_ps(_mm256_loadu_ps(vx + i), dt8));
+            __m256 py = _mm256_add_ps(_mm256_loadu_ps(y + i), _mm256_mul_ps(_mm256_loadu_ps(vy + i), dt8));
+            _mm256_storeu_ps(x + i, px);
+            _mm256_storeu_ps(y + i, py);
+            _mm256_storeu_ps(rotation + i, _mm256_add_ps(_mm256_loadu_ps(rotation + i), _mm256_mul_ps(_mm256_loadu_ps(spin + i), dt8)));
+            _mm256_storeu_ps(timer + i, _mm256_add_ps(_mm256_loadu_ps(timer + i), dt8));
+
+            __m256 outside = _mm256_or_ps(
+                _mm256_or_ps(_mm256_cmp_ps(px, minX8, _CMP_LT_OQ), _mm256_cmp_ps(px, maxX8, _CMP_GT_OQ)),
+                _mm256_or_ps(_mm256_cmp_ps(py, minY8, _CMP_LT_OQ), _mm256_cmp_ps(py, maxY8, _CMP_GT_OQ)));
+            int mask = _mm256_movemask_ps(outside);
+            for (int lane = 0; mask != 0; lane++, mask >>= 1) {
+                if (mask & 1) flags[i + lane] &= ~PROJECTILE_ACTIVE;
+            }
+        }
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64)
+        __m128 dt4 = _mm_set1_ps(dt);
+        __m128 minX4 = _mm_set1_ps(cullMinX);
+        __m128 minY4 = _mm_set1_ps(cullMinY);
+        __m128 maxX4 = _mm_set1_ps(cullMaxX);
+        __m128 maxY4 = _mm_set1_ps(cullMaxY);
+        for (; i + 4 <= count; i += 4) {
+            __m128 px = _mm_add_ps(_mm_loadu_ps(x + i), _mm_mul_ps(_mm_loadu_ps(vx + i), dt4));
+            __m128 py = _mm_add_ps(_mm_loadu_ps(y + i), _mm_mul_ps(_mm_loadu_ps(vy + i), dt4));
+            _mm_storeu_ps(x + i, px);
+            _mm_storeu_ps(y + i, py);
+            _mm_storeu_ps(rotation + i, _mm_add_ps(_mm_loadu_ps(rotation + i), _mm_mul_ps(_mm_loadu_ps(spin + i), dt4)));
+            _mm_storeu_ps(timer + i, _mm_add_ps(_mm_loadu_ps(timer + i), dt4));
+
+            __m128 outside = _mm_or_ps(
+                _mm_or_ps(_mm_cmplt_ps(px, minX4), _mm_cmpgt_ps(px, maxX4)),
+                _mm_or_ps(_mm_cmplt_ps(py, minY4), _mm_cmpgt_ps(py, maxY4)));
+            int mask = _mm_movemask_ps(outside);
+            for (int lane = 0; mask != 0; lane++, mask >>= 1) {
+                if (mask & 1) flags[i + lane] &= ~PROJECTILE_ACTIVE;
+            }
+        }
+#endif
+
+        for (; i < count; i++) {
+            x[i] += vx[i] * dt;
+            y[i] += vy[i] * dt;
+            rotation[i] += spin[i] * dt;
+            timer[i] += dt;
+            if (x[i] < cullMinX || x[i] > cullMaxX || y[i] < cullMinY || y[i] > cullMaxY) {
+                flags[i] &= ~PROJECTILE_ACTIVE;
+            }
+        }
     }
 
-    void update(float dt) {
-        if (!active) return;
-        sprite.move(0.0f, speed * dt);
+    /// purpose: drop switched-off entries by moving the last live entry into their slot; indices are not stable.
+    void compact() {
+        int i = 0;
+        while (i < count) {
+            if (flags[i] & PROJECTILE_ACTIVE) {
+                i++;
+            }
+            else {
+                count--;
+                if (i != count) moveEntry(count, i);
+            }
+        }
+    }
 
-        if (sprite.getPosition().y > screenHeight + 50) {
-            active = false;
+    void storePreviousPositions() {
+        for (int i = 0; i < count; i++) {
+            previousX[i] = x[i];
+            previousY[i] = y[i];
         }
     }
 
-    void draw(sf::RenderWindow& window) {
-        if (active) window.draw(sprite);
+    void clear() {
+        count = 0;
     }
 
-    bool isActive() const { return active; }
-    void deactivate() { active = false; }
-    sf::FloatRect getBounds() const { return sprite.getGlobalBounds(); }
-};
+    void kill(int i) {
+        flags[i] &= ~PROJECTILE_ACTIVE;
+    }
 
+    /// purpose: freeze an entry in place and show it with another kind (e.g. an explosion) while its timer runs.
+    void explode(int i, int explosionKind) {
+        flags[i] |= PROJECTILE_EXPLODING;
+        vx[i] = 0.0f;
+        vy[i] = 0.0f;
+        spin[i] = 0.0f;
+        timer[i] = 0.0f;
+        kind[i] = explosionKind;
+    }
+
+    unsigned int checksum(unsigned int hash) const {
+        hash = hashBytes(hash, &count, sizeof(count));
+        hash = hashBytes(hash, x, count * sizeof(float));
+        hash = hashBytes(hash, y, count * sizeof(float));
+        hash = hashBytes(hash, flags, count);
+        return hash;
+    }
+
+    int getCount() const { return count; }
+    int getCapacity() const { return capacity; }
+    bool isActive(int i) const { return (flags[i] & PROJECTILE_ACTIVE) != 0; }
+    bool isExploding(int i) const { return (flags[i] & PROJECTILE_EXPLODING) != 0; }
+    int getKind(int i) const { return kind[i]; }
+    float getTimer(int i) const { return timer[i]; }
+    sf::Vector2f getPosition(int i) const { return sf::Vector2f(x[i], y[i]); }
 
+    /// return: axis-aligned box of the rotated sprite, matching sf::Sprite::getGlobalBounds().
+    sf::FloatRect getBounds(int i) const {
+        float w = halfWidth[kind[i]];
+        float h = halfHeight[kind[i]];
+        if (rotation[i] != 0.0f) {
+            float radians = std::fmod(rotation[i], 360.0f) * 3.14159265f / 180.0f;
+            float c = std::fabs(std::cos(radians));
+            float s = std::fabs(std::sin(radians));
+            float rotatedW = c * w + s * h;
+            h = s * w + c * h;
+            w = rotatedW;
+        }
+        return sf::FloatRect(x[i] - w, y[i] - h, w * 2.0f, h * 2.0f);
+    }
 
+    void draw(SpriteBatch& batch, float alpha = 1.0f) {
+        for (int i = 0; i < count; i++) {
+            if (!(flags[i] & PROJECTILE_ACTIVE)) continue;
 
+            sf::Sprite& sprite = sprites[kind[i]];
+            sprite.setPosition(previousX[i] + (x[i] - previousX[i]) * alpha, previousY[i] + (y[i] - previousY[i]) * alpha);
+            sprite.setRotation(std::fmod(rotation[i], 360.0f));
+            batch.add(sprite);
+        }
+    }
+};
 
 
 
 class Enemy {
 protected:
     sf::Sprite sprite;
-    sf::Texture texture;
+    sf::Vector2f previousPosition;
+    TextureHandle texture;
     float speed;
     int health;
     bool active;
@@ -1546,11 +3914,11 @@ protected:
     int screenHeight;
 
 
-    static int totalEnemiesSpawned;
-    static int totalEnemiesDestroyed;
+    int spawnCount;
+    int destroyCount;
 
 public:
-    Enemy() : speed(100.0f), health(1), active(false), screenWidth(1920), screenHeight(1080) {}
+    Enemy() : speed(100.0f), health(1), active(false), screenWidth(1920), screenHeight(1080), spawnCount(0), destroyCount(0) {}
 
     virtual ~Enemy() {}
 
@@ -1563,51 +3931,51 @@ public:
         active = true;
         health = 1;
         sprite.setPosition(x, y);
-        totalEnemiesSpawned++;
+        previousPosition = sprite.getPosition();
+        spawnCount++;
     }
 
+    void storePreviousPosition() {
+        previousPosition = sprite.getPosition();
+    }
 
-    virtual void update(float dt) = 0;
 
+    virtual void update(float dt) = 0;
 
-    virtual void shoot(EnemyBullet* bullets, int maxBullets) {
 
-        for (int i = 0; i < maxBullets; i++) {
-            if (!bullets[i].isActive()) {
-                sf::Vector2f pos = sprite.getPosition();
-                bullets[i].fire(pos.x, pos.y + 20.0f);
-                break;
-            }
-        }
+    virtual void shoot(ProjectileField& bullets) {
+        sf::Vector2f pos = sprite.getPosition();
+        bullets.spawn(pos.x, pos.y + 20.0f, 0.0f, 300.0f);
     }
 
     void takeDamage() {
         health--;
         if (health <= 0) {
             active = false;
-            totalEnemiesDestroyed++;
+            destroyCount++;
         }
     }
 
-    void draw(sf::RenderWindow& window) {
-        if (active) window.draw(sprite);
+    void draw(SpriteBatch& batch, float alpha = 1.0f) {
+        if (active) batch.add(sprite, interpolatedStates(previousPosition, sprite.getPosition(), alpha).transform);
     }
 
     bool isActive() const { return active; }
     void deactivate() {
         if (active) {
             active = false;
-            totalEnemiesDestroyed++;
+            destroyCount++;
         }
     }
     sf::FloatRect getBounds() const { return sprite.getGlobalBounds(); }
 
 
-    static int getTotalSpawned() { return totalEnemiesSpawned; }
-    static int getTotalDestroyed() { return totalEnemiesDestroyed; }
-    static void resetStatistics() {
-        totalEnemiesSpawned = 0;
-        totalEnemiesDestroyed = 0;
+    /// purpose: per-object tallies; Level1 sums them over its pool, so levels on different threads never share counters.
+    int getSpawnCount() const { return spawnCount; }
+    int getDestroyCount() const { return destroyCount; }
+    void resetStatistics() {
+        spawnCount = 0;
+        destroyCount = 0;
     }
 
 
@@ -1615,10 +3983,6 @@ public:
 };
 
 
-int Enemy::totalEnemiesSpawned = 0;
-int Enemy::totalEnemiesDestroyed = 0;
-
-
 void debugEnemyStats(const Enemy& enemy) {
 
     cout << "=== ENEMY DEBUG INFO ===" << endl;
@@ -1627,8 +3991,8 @@ void debugEnemyStats(const Enemy& enemy) {
     cout << "Active: " << (enemy.active ? "Yes" : "No") << endl;
     cout << "Position: (" << enemy.sprite.getPosition().x << ", "
         << enemy.sprite.getPosition().y << ")" << endl;
-    cout << "Total Spawned: " << Enemy::getTotalSpawned() << endl;
-    cout << "Total Destroyed: " << Enemy::getTotalDestroyed() << endl;
+    cout << "Spawned: " << enemy.spawnCount << endl;
+    cout << "Destroyed: " << enemy.destroyCount << endl;
     cout << "========================" << endl;
 }
 
@@ -1637,7 +4001,7 @@ void debugEnemyStats(const Enemy& enemy) {
 
 class EnemyLevel1 : public Enemy {
 private:
-    sf::Clock shootTimer;
+    SimClock shootTimer;
     float shootInterval;
     int movementPattern;
     float movementTimer;
@@ -1645,22 +4009,31 @@ private:
 
 public:
     EnemyLevel1(const string& color = "Red", float enemySpeed = 80.0f, int pattern = 0) {
-        speed = enemySpeed;
         health = 1;
         shootInterval = 3.0f;
-        movementPattern = pattern;
         movementTimer = 0.0f;
         initialX = 0.0f;
 
+        setMovement(enemySpeed, pattern);
+        setAppearance(color);
+    }
+
+    /// purpose: swap the ship texture; done when a level is configured so spawning never touches the disk.
+    void setAppearance(const string& color) {
         string filename = "enemy" + color + "1.png";
         if (texture.loadFromFile(filename)) {
-            sprite.setTexture(texture);
+            texture.applyTo(sprite);
             sf::FloatRect bounds = sprite.getLocalBounds();
             sprite.setOrigin(bounds.width / 2.0f, bounds.height / 2.0f);
             sprite.setScale(0.8f, 0.8f);
         }
     }
 
+    void setMovement(float enemySpeed, int pattern) {
+        speed = enemySpeed;
+        movementPattern = pattern;
+    }
+
     void spawn(float x, float y) {
         Enemy::spawn(x, y);
         shootTimer.restart();
@@ -1673,6 +4046,7 @@ public:
         if (!active) return;
 
         movementTimer += dt;
+        shootTimer.advance(dt);
 
         if (movementPattern == 0) {
 
@@ -1726,7 +4100,7 @@ public:
 
 
     bool shouldShoot() {
-        if (shootTimer.getElapsedTime().asSeconds() >= shootInterval) {
+        if (shootTimer.getElapsedSeconds() >= shootInterval) {
             shootTimer.restart();
             return true;
         }
@@ -1740,8 +4114,9 @@ public:
 
 class BossEnemy : public Enemy {
 private:
-    sf::Clock shootTimer;
+    SimClock shootTimer;
     float shootInterval;
+    float initialSpeed;
     int maxHealth;
     sf::RectangleShape healthBarBg;
     sf::RectangleShape healthBarFill;
@@ -1749,13 +4124,14 @@ private:
 public:
     BossEnemy(const string& color = "Black", float bossSpeed = 50.0f) {
         speed = bossSpeed;
+        initialSpeed = bossSpeed;
         health = 50;
         maxHealth = 50;
         shootInterval = 1.0f;
 
         string filename = "boss_blue.png";
         if (texture.loadFromFile(filename)) {
-            sprite.setTexture(texture);
+            texture.applyTo(sprite);
             sf::FloatRect bounds = sprite.getLocalBounds();
             sprite.setOrigin(bounds.width / 2.0f, bounds.height / 2.0f);
             sprite.setScale(1.4f, 1.4f);
@@ -1774,6 +4150,7 @@ public:
     void spawn(float x, float y) {
         Enemy::spawn(x, y);
         health = maxHealth;
+        speed = initialSpeed;
         shootTimer.restart();
     }
 
@@ -1781,7 +4158,7 @@ public:
     void update(float dt) {
         if (!active) return;
 
-
+        shootTimer.advance(dt);
         sprite.move(speed * dt, 0.0f);
 
 
@@ -1816,7 +4193,7 @@ public:
 
 
     bool shouldShoot() {
-        if (shootTimer.getElapsedTime().asSeconds() >= shootInterval) {
+        if (shootTimer.getElapsedSeconds() >= shootInterval) {
             shootTimer.restart();
             return true;
         }
@@ -1824,24 +4201,24 @@ public:
     }
 
 
-    void shoot(EnemyBullet* bullets, int maxBullets) {
-        int bulletsShot = 0;
-        for (int i = 0; i < maxBullets && bulletsShot < 3; i++) {
-            if (!bullets[i].isActive()) {
-                sf::Vector2f pos = sprite.getPosition();
-                float offsetX = (bulletsShot - 1) * 40.0f;
-                bullets[i].fire(pos.x + offsetX, pos.y + 50.0f);
-                bulletsShot++;
-            }
+    void shoot(ProjectileField& bullets) {
+        sf::Vector2f pos = sprite.getPosition();
+        for (int bulletsShot = 0; bulletsShot < 3; bulletsShot++) {
+            float offsetX = (bulletsShot - 1) * 40.0f;
+            if (bullets.spawn(pos.x + offsetX, pos.y + 50.0f, 0.0f, 300.0f) < 0) break;
         }
     }
 
-    void draw(sf::RenderWindow& window) {
+    void draw(SpriteBatch& batch, float alpha = 1.0f) {
         if (active) {
-            window.draw(sprite);
+            sf::Transform offset = interpolatedStates(previousPosition, sprite.getPosition(), alpha).transform;
+            batch.add(sprite, offset);
 
-            window.draw(healthBarBg);
-            window.draw(healthBarFill);
+            sf::FloatRect back(healthBarBg.getPosition(), healthBarBg.getSize());
+            sf::FloatRect fill(healthBarFill.getPosition(), healthBarFill.getSize());
+            batch.addOutlinedRect(offset.transformRect(back), healthBarBg.getFillColor(),
+                healthBarBg.getOutlineThickness(), healthBarBg.getOutlineColor());
+            batch.addRect(offset.transformRect(fill), healthBarFill.getFillColor());
         }
     }
 };
@@ -1928,310 +4305,276 @@ public:
 
 
 
-class Bullet {
-private:
-    sf::Sprite sprite;
-    sf::Texture texture;
-    float speed;
-    bool active;
-    int screenHeight;
-    sf::Vector2f velocity;
+const float HUD_BAR_WIDTH = 200.0f;
+const float POWER_UP_DURATION = 10.0f;
 
 
-    int* damageMultiplier;
+/// purpose: Level1's score, lives, timer and power-up bars as one retained layer. The setters only compare and store;
+///          draw() rebuilds the vertices when a shown value changed and otherwise resubmits the cached ones.
+/// parameters: the timer is tracked in whole seconds and the bars in whole pixels, so most frames change nothing.
+class LevelHud {
+private:
+    TextureHandle numeralTextures[10];
+    TextureHandle lifeIconTexture;
+    TextureHandle xTexture;
+    sf::Sprite sprite;
+    SpriteBatch layer;
+    float screenW;
 
-public:
-    Bullet() : speed(800.0f), active(false), screenHeight(1080), velocity(0.0f, -1.0f) {
-        damageMultiplier = new int(1);
+    int score;
+    int lives;
+    int timerSeconds;
+    bool timerVisible;
+    int doubleFireWidth;
+    int shieldWidth;
+    bool doubleFireLow;
+    bool shieldLow;
+    bool dirty;
+
+    void addSprite(const TextureHandle& texture, float x, float y, float scale) {
+        texture.applyTo(sprite);
+        sprite.setScale(scale, scale);
+        sprite.setPosition(x, y);
+        layer.add(sprite);
     }
 
-
-    Bullet(const Bullet& other)
-        : sprite(other.sprite),
-        texture(other.texture),
-        speed(other.speed),
-        active(other.active),
-        screenHeight(other.screenHeight),
-        velocity(other.velocity) {
-
-        damageMultiplier = new int(*other.damageMultiplier);
-        cout << "Bullet copy constructor called (deep copy)" << endl;
+    void addBar(float y, int fillWidth, const sf::Color& fillColor) {
+        float barX = screenW / 2.0f - HUD_BAR_WIDTH / 2.0f;
+        layer.addOutlinedRect(sf::FloatRect(barX, y, HUD_BAR_WIDTH, 15.0f), sf::Color(50, 50, 50, 200), 2.0f, sf::Color::White);
+        layer.addRect(sf::FloatRect(barX, y, (float)fillWidth, 15.0f), fillColor);
     }
 
+    void rebuild() {
+        layer.clear();
 
-    Bullet& operator=(const Bullet& other) {
-        if (this != &other) {
-            sprite = other.sprite;
-            texture = other.texture;
-            speed = other.speed;
-            active = other.active;
-            screenHeight = other.screenHeight;
-            velocity = other.velocity;
-
-
-            delete damageMultiplier;
-            damageMultiplier = new int(*other.damageMultiplier);
+        addSprite(lifeIconTexture, 20.0f, 20.0f, 1.0f);
+        addSprite(xTexture, 70.0f, 23.0f, 1.0f);
+        if (lives >= 0 && lives <= 9) {
+            addSprite(numeralTextures[lives], 110.0f, 23.0f, 1.0f);
         }
-        return *this;
-    }
 
+        int digits[10];
+        int digitCount = 0;
+        int remaining = (score > 0) ? score : 0;
+        do {
+            digits[digitCount++] = remaining % 10;
+            remaining /= 10;
+        } while (remaining > 0);
 
-    ~Bullet() {
-        delete damageMultiplier;
-    }
-
-    bool loadTexture(const string& texturePath) {
-        try {
-            if (!texture.loadFromFile(texturePath)) {
-                throw FileLoadException(texturePath);
-            }
-            sprite.setTexture(texture);
-            sf::FloatRect bounds = sprite.getLocalBounds();
-            sprite.setOrigin(bounds.width / 2.0f, bounds.height / 2.0f);
-            return true;
-        }
-        catch (const FileLoadException& e) {
-            cout << "ERROR: " << e.what() << endl;
-            return false;
+        int shown = (digitCount < 6) ? digitCount : 6;
+        float startX = screenW - 60.0f - (shown - 1) * 50.0f;
+        for (int i = 0; i < shown; i++) {
+            addSprite(numeralTextures[digits[digitCount - 1 - i]], startX + i * 50.0f, 20.0f, 1.8f);
         }
-    }
-
-    void fire(sf::Vector2f startPosition, float rotationDegrees = 0.0f) {
-        active = true;
-        sprite.setPosition(startPosition);
-        sprite.setRotation(rotationDegrees);
-
-        float rotationRadians = rotationDegrees * 3.14159265f / 180.0f;
-        velocity.x = std::sin(rotationRadians);
-        velocity.y = -std::cos(rotationRadians);
-    }
-
-    void update(float dt) {
-        if (!active) return;
-        sprite.move(velocity.x * speed * dt, velocity.y * speed * dt);
 
-        sf::Vector2f pos = sprite.getPosition();
-        if (pos.y < -50.0f || pos.y > screenHeight + 50.0f || pos.x < -50.0f || pos.x > 1920 + 50.0f) {
-            deactivate();
+        float barY = 60.0f;
+        if (doubleFireWidth > 0) {
+            addBar(barY, doubleFireWidth, doubleFireLow ? sf::Color(255, 50, 50) : sf::Color(255, 100, 50));
+            barY += 20.0f;
         }
-    }
-
-    void draw(sf::RenderWindow& window) {
-        if (active) {
-            window.draw(sprite);
+        if (shieldWidth > 0) {
+            addBar(barY, shieldWidth, shieldLow ? sf::Color(255, 50, 50) : sf::Color(50, 255, 100));
         }
-    }
-
-    void deactivate() {
-        active = false;
-    }
 
-    bool isActive() const {
-        return active;
-    }
+        if (timerVisible) {
+            int minutes = timerSeconds / 60;
+            int seconds = timerSeconds % 60;
+            if (minutes > 99) minutes = 99;
 
-    void setScreenHeight(int height) {
-        screenHeight = height;
-    }
+            float centerX = screenW * 0.5f;
+            float digitSpacing = 40.0f;
+            addSprite(numeralTextures[minutes / 10], centerX - 2.5f * digitSpacing, 20.0f, 1.5f);
+            addSprite(numeralTextures[minutes % 10], centerX - 1.5f * digitSpacing, 20.0f, 1.5f);
+            addSprite(numeralTextures[seconds / 10], centerX + 0.5f * digitSpacing, 20.0f, 1.5f);
+            addSprite(numeralTextures[seconds % 10], centerX + 1.5f * digitSpacing, 20.0f, 1.5f);
 
-    sf::FloatRect getBounds() const {
-        if (active) {
-            return sprite.getGlobalBounds();
+            layer.addCircle(sf::Vector2f(centerX - 11.0f, 29.0f), 4.0f, sf::Color::White);
+            layer.addCircle(sf::Vector2f(centerX - 11.0f, 49.0f), 4.0f, sf::Color::White);
         }
-        return sf::FloatRect(0, 0, 0, 0);
-    }
 
-
-    int getDamageMultiplier() const {
-        return *damageMultiplier;
+        dirty = false;
     }
 
-    void setDamageMultiplier(int mult) {
-        *damageMultiplier = mult;
+    static int barWidthFor(bool active, float secondsLeft) {
+        if (!active || secondsLeft <= 0.0f) return 0;
+        int width = (int)std::ceil(secondsLeft / POWER_UP_DURATION * HUD_BAR_WIDTH);
+        return (width < (int)HUD_BAR_WIDTH) ? width : (int)HUD_BAR_WIDTH;
     }
-};
-
-
-
-
-class Meteor {
-private:
-    sf::Sprite sprite;
-    sf::Texture bigTexture;
-    sf::Texture smallTexture;
-    sf::Texture explosionTexture;
-    float speed;
-    bool active;
-    bool isExploding;
-    int type;
-    int screenWidth;
-    int screenHeight;
-    sf::Clock explosionTimer;
 
 public:
-    Meteor() : speed(0.0f), active(false), isExploding(false), type(0), screenWidth(1920), screenHeight(1080) {
-    }
+    LevelHud() : screenW(1920.0f), score(0), lives(0), timerSeconds(0), timerVisible(false),
+        doubleFireWidth(0), shieldWidth(0), doubleFireLow(false), shieldLow(false), dirty(true) {}
 
-    bool loadTextures() {
+    void loadTextures(int screenWidth) {
+        screenW = (float)screenWidth;
+        dirty = true;
 
-        if (!bigTexture.loadFromFile("meteorBrown_big1.png")) {
-            cout << "Error loading big meteor texture!" << endl;
-            return false;
+        for (int i = 0; i < 10; i++) {
+            string filename = "numeral" + std::to_string(i) + ".png";
+            if (!numeralTextures[i].loadFromFile(filename)) {
+                cout << "Warning: Could not load " << filename << endl;
+            }
         }
 
-
-        if (!smallTexture.loadFromFile("meteorBrown_small1.png")) {
-            cout << "Error loading small meteor texture!" << endl;
-            return false;
+        if (!lifeIconTexture.loadFromFile("playerLife1_red.png")) {
+            cout << "Warning: Could not load life icon!" << endl;
         }
 
-
-        if (!explosionTexture.loadFromFile("playerShip2_damage1.png")) {
-            cout << "Warning: Could not load explosion texture!" << endl;
-
+        if (!xTexture.loadFromFile("numeralX.png")) {
+            cout << "Warning: Could not load numeralX.png!" << endl;
         }
-
-        return true;
     }
 
-    void setScreenSize(int width, int height) {
-        screenWidth = width;
-        screenHeight = height;
+    void setScore(int value) {
+        if (value != score) {
+            score = value;
+            dirty = true;
+        }
     }
 
-    void spawn(float spawnScreenWidth) {
-        active = true;
-        isExploding = false;
-
-
-        float randomX = (float)(rand() % (int)spawnScreenWidth);
-        sprite.setPosition(randomX, -100.0f);
-
-
-        type = rand() % 2;
-
-        if (type == 1) {
-
-            sprite.setTexture(bigTexture);
-            speed = 150.0f + (rand() % 50);
-            sprite.setScale(1.0f, 1.0f);
+    void setLives(int value) {
+        if (value != lives) {
+            lives = value;
+            dirty = true;
         }
-        else {
+    }
 
-            sprite.setTexture(smallTexture);
-            speed = 250.0f + (rand() % 100);
-            sprite.setScale(1.0f, 1.0f);
+    void setTimer(float elapsedSeconds, bool visible) {
+        int seconds = (int)elapsedSeconds;
+        if (seconds != timerSeconds || visible != timerVisible) {
+            timerSeconds = seconds;
+            timerVisible = visible;
+            dirty = true;
         }
-
-
-        sf::FloatRect bounds = sprite.getLocalBounds();
-        sprite.setOrigin(bounds.width / 2.0f, bounds.height / 2.0f);
-
-
-        sprite.setRotation((float)(rand() % 360));
     }
 
-    void takeDamage() {
-        if (isExploding) return;
-
-        isExploding = true;
-        sprite.setTexture(explosionTexture);
-        explosionTimer.restart();
-
+    /// parameters: seconds left on each power-up, ignored when it is not active.
+    void setPowerUps(bool doubleFire, float doubleFireLeft, bool shield, float shieldLeft) {
+        int doubleWidth = barWidthFor(doubleFire, doubleFireLeft);
+        int shieldBar = barWidthFor(shield, shieldLeft);
+        bool doubleLow = doubleFireLeft < 5.0f;
+        bool shieldBarLow = shieldLeft < 5.0f;
+        if (doubleWidth != doubleFireWidth || shieldBar != shieldWidth || doubleLow != doubleFireLow || shieldBarLow != shieldLow) {
+            doubleFireWidth = doubleWidth;
+            shieldWidth = shieldBar;
+            doubleFireLow = doubleLow;
+            shieldLow = shieldBarLow;
+            dirty = true;
+        }
+    }
 
-        sf::FloatRect bounds = sprite.getLocalBounds();
-        sprite.setOrigin(bounds.width / 2.0f, bounds.height / 2.0f);
+    void draw(sf::RenderTarget& target) {
+        if (dirty) {
+            rebuild();
+        }
+        layer.submit(target);
     }
+};
 
-    void update(float dt) {
-        if (!active) return;
 
-        if (isExploding) {
 
-            if (explosionTimer.getElapsedTime().asSeconds() > 0.2f) {
-                active = false;
-                isExploding = false;
-            }
 
-        }
-        else {
+const int METEOR_SMALL = 0;
+const int METEOR_BIG = 1;
+const int METEOR_EXPLOSION = 2;
 
-            sprite.move(0.0f, speed * dt);
 
+/// purpose: lock-free hand-over of the newest value from one writer thread to one reader thread. The writer fills
+///          back() and publishes it; latest() moves the reader to the newest published slot, or keeps its current one.
+/// return: neither side waits, and no slot is written while the reader holds it.
+template<typename T>
+class TripleBuffer {
+private:
+    static const int FRESH = 4;
 
-            sprite.rotate(30.0f * dt);
+    T slots[3];
+    std::atomic<int> middle;
+    int backIndex;
+    int frontIndex;
 
+public:
+    TripleBuffer() : middle(1), backIndex(0), frontIndex(2) {}
 
-            if (sprite.getPosition().y > screenHeight + 100.0f) {
-                active = false;
-            }
-        }
+    T& back() {
+        return slots[backIndex];
     }
 
-    void draw(sf::RenderWindow& window) {
-        if (active) {
-            window.draw(sprite);
-        }
+    void publish() {
+        backIndex = middle.exchange(backIndex | FRESH, std::memory_order_acq_rel) & 3;
     }
 
-    void deactivate() {
-        active = false;
-        isExploding = false;
+    const T& latest() {
+        if (middle.load(std::memory_order_acquire) & FRESH) {
+            frontIndex = middle.exchange(frontIndex, std::memory_order_acq_rel) & 3;
+        }
+        return slots[frontIndex];
     }
+};
 
-    bool isActive() const {
-        return active;
-    }
 
-    bool getIsExploding() const {
-        return isExploding;
-    }
+/// purpose: everything Level1 needs to draw one tick without touching the simulation: recorded sprite layers plus
+///          the hud values and wave banner.
+/// parameters: level and generation name the level and reset() the snapshot was taken from.
+struct LevelSnapshot {
+    SnapshotLayer layers[SNAPSHOT_LAYERS];
+    int layerCount;
+    const void* level;
+    unsigned int generation;
 
-    int getType() const {
-        return type;
-    }
+    int score;
+    int lives;
+    float elapsedTime;
+    bool timerVisible;
+    bool hasDoubleFire;
+    float doubleFireTimer;
+    bool hasShield;
+    float shieldTimer;
 
-    sf::FloatRect getBounds() const {
-        if (active && !isExploding) {
-            return sprite.getGlobalBounds();
-        }
-        return sf::FloatRect(0, 0, 0, 0);
-    }
+    bool showWave;
+    string waveText;
+    sf::Color waveColor;
 
-    sf::Vector2f getPosition() const {
-        return sprite.getPosition();
-    }
+    LevelSnapshot() : layerCount(0), level(nullptr), generation(0), score(0), lives(0), elapsedTime(0.0f),
+        timerVisible(false), hasDoubleFire(false), doubleFireTimer(0.0f), hasShield(false), shieldTimer(0.0f),
+        showWave(false) {}
 };
 
 
+/// purpose: stamps each Level1 construction and reset(), so a snapshot from an earlier run is never taken for current.
+std::atomic<unsigned int> levelGenerations(0);
+
+
+
+
 class Level1 {
 private:
-    sf::Texture bgTexture;
+    TextureHandle bgTexture;
     sf::Sprite bgSprite;
 
-    sf::Texture playerTexture;
+    TextureHandle playerTexture;
     sf::Sprite player;
+    sf::Vector2f previousPlayerPosition;
 
 
-    Bullet bullets[20];
+    ProjectileField playerBullets;
     sf::SoundBuffer laserSoundBuffer;
     sf::Sound laserSound;
     bool soundLoaded;
     bool spaceWasPressed;
 
 
-    Meteor meteors[20];
-    sf::Clock meteorSpawnTimer;
+    ProjectileField meteors;
+    SimClock meteorSpawnTimer;
     float meteorSpawnInterval;
 
 
     bool isDestroyed;
-    sf::Texture playerDestroyedTexture;
+    TextureHandle playerDestroyedTexture;
     int lives;
 
 
     PowerUp powerups[10];
-    sf::Clock powerUpSpawnTimer;
+    SimClock powerUpSpawnTimer;
     float powerUpSpawnInterval;
 
 
@@ -2239,34 +4582,31 @@ private:
     float shieldTimer;
     bool hasDoubleFire;
     float doubleFireTimer;
-    sf::Texture shieldTexture;
+    TextureHandle shieldTexture;
     sf::Sprite shieldSprite;
 
 
     sf::RectangleShape powerUpFlash;
-    sf::Clock powerUpFlashTimer;
+    SimClock powerUpFlashTimer;
     sf::Color powerUpFlashColor;
     bool showPowerUpFlash;
 
 
-    Enemy* enemies[10];
-    EnemyBullet enemyBullets[50];
-    sf::Clock enemySpawnTimer;
+    ObjectPool<EnemyLevel1>* enemyPool;
+    ProjectileField enemyBullets;
+    SimClock enemySpawnTimer;
     float enemySpawnInterval;
     string enemyColor;
-    ObjectPool<Bullet>* bulletPool;
+    SpatialGrid collisionGrid;
+    int gridResults[64];
+    SpriteBatch batch;
+    LevelSnapshot liveSnapshot;
+    sf::VertexArray snapshotVertices;
+    unsigned int generation;
 
 
     int score;
-    sf::Texture numeralTextures[10];
-    sf::Sprite scoreDigits[6];
-
-
-    sf::Texture lifeIconTexture;
-    sf::Sprite lifeIcon;
-    sf::Texture xTexture;
-    sf::Sprite xSprite;
-    sf::Sprite lifeCountSprite;
+    LevelHud hud;
 
     float speed;
     float tiltAngle;
@@ -2289,12 +4629,16 @@ private:
     bool allWaveEnemiesCleared;
 
 
-    TypewriterText waveAnnouncement;
+    string waveMessage;
+    string waveShown;
+    float waveTypeTimer;
+    float waveTypeInterval;
     sf::Font waveFont;
+    sf::Text waveText;
     bool showingWaveAnnouncement;
-    sf::Clock waveAnnouncementTimer;
+    SimClock waveAnnouncementTimer;
     float waveAnnouncementDuration;
-    sf::Clock waveDelayTimer;
+    SimClock waveDelayTimer;
 
 
 
@@ -2302,8 +4646,6 @@ private:
     sf::Clock gameTimer;
     float elapsedTime;
     bool timerRunning;
-    sf::Texture timerNumeralTextures[10];
-    sf::Sprite timerDigits[6];
     int scoreOffset;
 
 
@@ -2311,11 +4653,26 @@ private:
 
 
     EnemyFormation currentFormation;
+    BossEnemy bossInstance;
     BossEnemy* bossEnemy;
     bool isBossWave;
 
+
+    unsigned int levelSeed;
+    RandomStream meteorRandom;
+    RandomStream powerUpRandom;
+    RandomStream waveRandom;
+
+
+    InputReplay replay;
+    ReplaySettings settingsBeforeReplay;
+    bool recordingReplay;
+    bool playingReplay;
+    long replayTick;
+    long replayDivergedAt;
+
 public:
-    Level1() {
+    Level1() : playerBullets(20), meteors(20), enemyBullets(50) {
         scoreOffset = 0;
         speed = 450.0f;
         tiltAngle = 0.0f;
@@ -2334,6 +4691,15 @@ public:
 
         bossEnemy = nullptr;
         isBossWave = false;
+        snapshotVertices.setPrimitiveType(sf::Triangles);
+        generation = ++levelGenerations;
+
+        setSeed((unsigned int)time(nullptr));
+
+        recordingReplay = false;
+        playingReplay = false;
+        replayTick = 0;
+        replayDivergedAt = -1;
 
 
         hasShield = false;
@@ -2347,8 +4713,8 @@ public:
         powerUpFlash.setFillColor(sf::Color(255, 255, 255, 0));
 
 
-        if (shieldTexture.loadFromFile("shield3.png")) {
-            shieldSprite.setTexture(shieldTexture);
+        if (!headlessMode && shieldTexture.loadFromFile("shield3.png")) {
+            shieldTexture.applyTo(shieldSprite);
             sf::FloatRect bounds = shieldSprite.getLocalBounds();
             shieldSprite.setOrigin(bounds.width / 2.0f, bounds.height / 2.0f);
             shieldSprite.setScale(1.2f, 1.2f);
@@ -2356,16 +4722,19 @@ public:
 
 
 
-        bulletPool = new ObjectPool<Bullet>(20);
-        for (int i = 0; i < 20; i++) {
-            bulletPool->get(i)->loadTexture("laserRed02.png");
-            bulletPool->get(i)->setScreenHeight(screenH);
+        if (!playerBullets.setTexture(0, "laserRed02.png")) {
+            cout << "Error loading bullet texture!" << endl;
         }
+        playerBullets.setCullBox(-50.0f, -50.0f, screenW + 50.0f, screenH + 50.0f);
 
-        for (int i = 0; i < 20; i++) {
-            meteors[i].loadTextures();
-            meteors[i].setScreenSize(screenW, screenH);
+        if (!meteors.setTexture(METEOR_SMALL, "meteorBrown_small1.png") ||
+            !meteors.setTexture(METEOR_BIG, "meteorBrown_big1.png")) {
+            cout << "Error loading meteor textures!" << endl;
         }
+        if (!meteors.setTexture(METEOR_EXPLOSION, "playerShip2_damage1.png")) {
+            cout << "Warning: Could not load explosion texture!" << endl;
+        }
+        meteors.setCullBox(-1.0e30f, -1.0e30f, 1.0e30f, screenH + 100.0f);
 
 
         for (int i = 0; i < 10; i++) {
@@ -2376,54 +4745,27 @@ public:
 
         enemySpawnInterval = 1.5f;
         enemyColor = "Red";
-        for (int i = 0; i < 10; i++) {
-            enemies[i] = 0;
-        }
-
-
-        for (int i = 0; i < 50; i++) {
-            enemyBullets[i].loadTexture("laserRed02.png");
-            enemyBullets[i].setScreenHeight(screenH);
+        enemyPool = new ObjectPool<EnemyLevel1>(10);
+        for (int i = 0; i < enemyPool->getPoolSize(); i++) {
+            enemyPool->get(i)->setScreenSize(screenW, screenH);
         }
+        bossInstance.setScreenSize(screenW, screenH);
 
 
+        enemyBullets.setTexture(0, "laserRed02.png");
+        enemyBullets.setCullBox(-1.0e30f, -1.0e30f, 1.0e30f, screenH + 50.0f);
 
-        if (laserSoundBuffer.loadFromFile("sfx_laser1.ogg")) {
-            laserSound.setBuffer(laserSoundBuffer);
-            soundLoaded = true;
-        }
 
 
-        for (int i = 0; i < 10; i++) {
-            string filename = "numeral" + std::to_string(i) + ".png";
-            if (!numeralTextures[i].loadFromFile(filename)) {
-                cout << "Warning: Could not load " << filename << endl;
+        if (!headlessMode) {
+            if (loadSoundAsset(laserSoundBuffer, "sfx_laser1.ogg")) {
+                laserSound.setBuffer(laserSoundBuffer);
+                soundLoaded = true;
             }
-        }
-
-
-        if (!lifeIconTexture.loadFromFile("playerLife1_red.png")) {
-            cout << "Warning: Could not load life icon!" << endl;
-        }
-        lifeIcon.setTexture(lifeIconTexture);
-        lifeIcon.setScale(1.0f, 1.0f);
-        lifeIcon.setPosition(20.0f, 20.0f);
 
 
-        if (!xTexture.loadFromFile("numeralX.png")) {
-            cout << "Warning: Could not load numeralX.png!" << endl;
+            hud.loadTextures(screenW);
         }
-        xSprite.setTexture(xTexture);
-        xSprite.setScale(1.0f, 1.0f);
-        xSprite.setPosition(70.0f, 23.0f);
-
-
-        lifeCountSprite.setScale(1.0f, 1.0f);
-        lifeCountSprite.setPosition(110.0f, 23.0f);
-        updateLivesDisplay();
-
-
-        updateScoreDisplay();
 
 
         currentWave = 0;
@@ -2438,69 +4780,56 @@ public:
         elapsedTime = 0.0f;
         timerRunning = false;
 
-
-        for (int i = 0; i < 10; i++) {
-            timerNumeralTextures[i] = numeralTextures[i];
-        }
         waveAnnouncementDuration = 2.5f;
+        waveTypeTimer = 0.0f;
+        waveTypeInterval = 0.05f;
 
 
     }
 
     ~Level1() {
-
-        for (int i = 0; i < 10; i++) {
-            if (enemies[i] != 0) {
-                delete enemies[i];
-                enemies[i] = 0;
-            }
-        }
-        if (bossEnemy != nullptr) {
-            delete bossEnemy;
-            bossEnemy = nullptr;
-        }
-
-
-        delete bulletPool;
+        delete enemyPool;
     }
 
     bool loadWaveFont(const string& fontPath) {
-        if (!waveFont.loadFromFile(fontPath)) {
+        if (!loadFontAsset(waveFont, fontPath)) {
             return false;
         }
         return true;
     }
 
     bool loadAssets(const string& backgroundFile = "bg2.jpg", const string& shipColor = "Red") {
-        if (!bgTexture.loadFromFile(backgroundFile)) {
-            cout << "Error loading background!";
-            return false;
-        }
-        bgSprite.setTexture(bgTexture);
+        if (!headlessMode) {
+            if (!bgTexture.loadFromFile(backgroundFile)) {
+                cout << "Error loading background!";
+                return false;
+            }
+            bgTexture.applyTo(bgSprite);
 
 
-        bgSprite.setScale(
-            (float)screenW / bgTexture.getSize().x,
-            (float)screenH / bgTexture.getSize().y
-        );
-        bgSprite.setPosition(0.0f, 0.0f);
+            bgSprite.setScale(
+                (float)screenW / bgTexture.getSize().x,
+                (float)screenH / bgTexture.getSize().y
+            );
+            bgSprite.setPosition(0.0f, 0.0f);
 
 
-        sf::Vector2u texSize = bgTexture.getSize();
+            sf::Vector2u texSize = bgTexture.getSize();
 
 
-        float scaleX = (float)screenW / texSize.x;
-        float scaleY = (float)screenH / texSize.y;
+            float scaleX = (float)screenW / texSize.x;
+            float scaleY = (float)screenH / texSize.y;
 
 
-        float scale = (scaleX > scaleY) ? scaleX : scaleY;
+            float scale = (scaleX > scaleY) ? scaleX : scaleY;
 
-        bgSprite.setScale(scale, scale);
+            bgSprite.setScale(scale, scale);
 
 
-        float offsetX = ((float)screenW - (texSize.x * scale)) / 2.0f;
-        float offsetY = ((float)screenH - (texSize.y * scale)) / 2.0f;
-        bgSprite.setPosition(offsetX, offsetY);
+            float offsetX = ((float)screenW - (texSize.x * scale)) / 2.0f;
+            float offsetY = ((float)screenH - (texSize.y * scale)) / 2.0f;
+            bgSprite.setPosition(offsetX, offsetY);
+        }
 
 
         string shipFile = "playerShip1_red.png";
@@ -2518,12 +4847,13 @@ public:
             cout << "Error loading player jet!";
             return false;
         }
-        player.setTexture(playerTexture);
+        playerTexture.applyTo(player);
         player.setOrigin(
             playerTexture.getSize().x / 2.0f,
             playerTexture.getSize().y / 2.0f
         );
         player.setPosition((float)screenW / 2.0f, (float)screenH - 250.0f);
+        previousPlayerPosition = player.getPosition();
 
 
         if (!playerDestroyedTexture.loadFromFile("playerShip1_damage3.png")) {
@@ -2545,19 +4875,14 @@ public:
         spaceWasPressed = false;
 
 
-        player.setTexture(playerTexture);
+        playerTexture.applyTo(player);
         player.setPosition((float)screenW / 2.0f, (float)screenH - 250.0f);
         player.setRotation(0.0f);
+        previousPlayerPosition = player.getPosition();
 
 
-        for (int i = 0; i < 20; i++) {
-            bulletPool->get(i)->deactivate();
-        }
-
-
-        for (int i = 0; i < 20; i++) {
-            meteors[i].deactivate();
-        }
+        playerBullets.clear();
+        meteors.clear();
 
 
         for (int i = 0; i < 10; i++) {
@@ -2571,14 +4896,11 @@ public:
         doubleFireTimer = 0.0f;
 
 
-        for (int i = 0; i < 10; i++) {
-            if (enemies[i] != 0) {
-                enemies[i]->deactivate();
-            }
-        }
-        for (int i = 0; i < 50; i++) {
-            enemyBullets[i].deactivate();
+        for (int i = 0; i < enemyPool->getActiveCount(); i++) {
+            enemyPool->getActive(i)->deactivate();
         }
+        enemyPool->clear();
+        enemyBullets.clear();
 
 
         currentWave = 0;
@@ -2591,17 +4913,23 @@ public:
         allWaveEnemiesCleared = true;
         showingWaveAnnouncement = false;
         meteorSpawnTimer.restart();
+        powerUpSpawnTimer.restart();
+        enemySpawnTimer.restart();
 
-        if (bossEnemy != nullptr) {
-            delete bossEnemy;
-            bossEnemy = nullptr;
-        }
+        bossInstance.deactivate();
+        bossEnemy = nullptr;
         isBossWave = false;
         currentFormation.reset();
+        generation = ++levelGenerations;
+
+        for (int i = 0; i < enemyPool->getPoolSize(); i++) {
+            enemyPool->get(i)->resetStatistics();
+        }
+        bossInstance.resetStatistics();
 
 
-        updateScoreDisplay();
-        updateLivesDisplay();
+        replayTick = 0;
+        replayDivergedAt = -1;
     }
     void startTimer() {
         if (!timerRunning) {
@@ -2624,6 +4952,9 @@ public:
         enemySpawnInterval = enemyInterval;
         speed = playerSpd;
         enemyColor = enemyCol;
+        for (int i = 0; i < enemyPool->getPoolSize(); i++) {
+            enemyPool->get(i)->setAppearance(enemyColor);
+        }
         maxWaves = waves;
         currentWave = 0;
         enemiesPerWave = 0;
@@ -2631,7 +4962,7 @@ public:
         waveInProgress = false;
     }
 
-    int calculateTargetScore() {
+    int calculateTargetScore() const {
         int targetScore = 0;
 
         if (maxWaves == 2) {
@@ -2651,6 +4982,33 @@ public:
         return targetScore;
     }
 
+    bool isBossLevel() const {
+        return maxWaves == 3 && enemyColor == "Green";
+    }
+
+    /// return: true once the level's goal is met: the boss is down on the boss level, the target score elsewhere.
+    bool isCleared() {
+        if (isDestroyed) return false;
+        return isBossLevel() ? isBossDefeated() : score >= calculateTargetScore();
+    }
+
+    /// return: enemies spawned and destroyed since the last reset(), boss included.
+    int getEnemiesSpawned() const {
+        int total = bossInstance.getSpawnCount();
+        for (int i = 0; i < enemyPool->getPoolSize(); i++) {
+            total += enemyPool->get(i)->getSpawnCount();
+        }
+        return total;
+    }
+
+    int getEnemiesDestroyed() const {
+        int total = bossInstance.getDestroyCount();
+        for (int i = 0; i < enemyPool->getPoolSize(); i++) {
+            total += enemyPool->get(i)->getDestroyCount();
+        }
+        return total;
+    }
+
     bool isBossDefeated() const {
 
         if (bossEnemy != nullptr && !bossEnemy->isActive() && isBossWave) {
@@ -2659,20 +5017,58 @@ public:
         return false;
     }
 
-    void update(float dt) {
+    /// purpose: advance the level by one tick using injected input; never touches the keyboard or the window.
+    ///          While a replay plays, its recorded input replaces the given one; while recording, the tick is logged.
+    ///          Both reseed the level on the first tick after reset(), so nothing that runs in between can shift it.
+    /// parameters: dt is the tick length in seconds; input is the player intent for this tick.
+    void update(float dt, const PlayerInput& input) {
+        if (playingReplay) {
+            if (isReplayFinished()) return;
+
+            if (replayTick == 0) setSeed(replay.getSettings().seed);
+            simulateTick(dt, replay.getInput(replayTick));
+            if (replayDivergedAt < 0 && stateChecksum() != replay.getChecksum(replayTick)) {
+                replayDivergedAt = replayTick;
+            }
+            replayTick++;
+            return;
+        }
+
+        if (recordingReplay) {
+            if (replayTick == 0) {
+                setSeed(waveRandom.next());
+                replay.begin(currentReplaySettings());
+            }
+            simulateTick(dt, input);
+            replay.record(input, stateChecksum());
+            replayTick++;
+            return;
+        }
+
+        simulateTick(dt, input);
+    }
+
+    void simulateTick(float dt, const PlayerInput& input) {
+        PROFILE_ZONE(PROFILE_LEVEL_UPDATE);
+        meteorSpawnTimer.advance(dt);
+        powerUpSpawnTimer.advance(dt);
+        powerUpFlashTimer.advance(dt);
+        enemySpawnTimer.advance(dt);
+        waveAnnouncementTimer.advance(dt);
+        waveDelayTimer.advance(dt);
+        storePreviousPositions();
+
         if (timerRunning && !isDestroyed) {
 
             elapsedTime += dt;
-            updateTimerDisplay();
         }
 
         if (showingWaveAnnouncement) {
-            waveAnnouncement.update(dt);
+            typeWaveAnnouncement(dt);
 
 
-            if (waveAnnouncementTimer.getElapsedTime().asSeconds() >= waveAnnouncementDuration) {
+            if (waveAnnouncementTimer.getElapsedSeconds() >= waveAnnouncementDuration) {
                 showingWaveAnnouncement = false;
-                waveAnnouncement.setActive(false);
             }
 
 
@@ -2690,10 +5086,10 @@ public:
         float moveX = 0.0f;
         float moveY = 0.0f;
 
-        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Left))  moveX -= speed * dt;
-        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Right)) moveX += speed * dt;
-        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Up))    moveY -= speed * dt;
-        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Down))  moveY += speed * dt;
+        if (input.left)  moveX -= speed * dt;
+        if (input.right) moveX += speed * dt;
+        if (input.up)    moveY -= speed * dt;
+        if (input.down)  moveY += speed * dt;
 
         player.move(moveX, moveY);
 
@@ -2717,7 +5113,7 @@ public:
         player.setRotation(tiltAngle);
 
 
-        handleShooting();
+        handleShooting(input);
 
 
         updateBullets(dt);
@@ -2752,7 +5148,7 @@ public:
 
 
         if (showPowerUpFlash) {
-            float elapsed = powerUpFlashTimer.getElapsedTime().asSeconds();
+            float elapsed = powerUpFlashTimer.getElapsedSeconds();
             if (elapsed < 0.3f) {
                 float alpha = 100.0f * (1.0f - elapsed / 0.3f);
                 sf::Color flashColor = powerUpFlashColor;
@@ -2766,72 +5162,235 @@ public:
         }
 
 
+        spawnEnemies();
+        updateEnemies(dt);
+        updateEnemyBullets(dt);
+
+
+        checkCollisions();
+    }
+
+    /// purpose: rebuild the broad-phase grid and resolve every hit of this tick; run after all movement.
+    void checkCollisions() {
+        PROFILE_ZONE(PROFILE_COLLISIONS);
+        buildCollisionGrid();
         checkBulletMeteorCollisions();
         if (!hasShield) {
             checkPlayerMeteorCollisions();
         }
         checkPowerUpCollisions();
-
-
-        spawnEnemies();
-        updateEnemies(dt);
-        updateEnemyBullets(dt);
         checkBulletEnemyCollisions();
         checkPlayerEnemyBulletCollisions();
     }
+
+    /// purpose: restart the level's random sequences; meteors, power-ups and waves draw from separate streams so
+    ///          a change in one subsystem does not reshuffle the others.
+    void setSeed(unsigned int seed) {
+        levelSeed = seed;
+        meteorRandom.reseed(seed, 1);
+        powerUpRandom.reseed(seed, 2);
+        waveRandom.reseed(seed, 3);
+    }
+
+    unsigned int getSeed() const { return levelSeed; }
+
+    /// purpose: fingerprint of everything a tick can change; recorded per tick and compared during playback.
+    unsigned int stateChecksum() const {
+        unsigned int hash = HASH_SEED;
+        sf::Vector2f playerPos = player.getPosition();
+        float playerRotation = player.getRotation();
+        hash = hashBytes(hash, &playerPos, sizeof(playerPos));
+        hash = hashBytes(hash, &playerRotation, sizeof(playerRotation));
+        hash = hashBytes(hash, &score, sizeof(score));
+        hash = hashBytes(hash, &lives, sizeof(lives));
+        hash = hashBytes(hash, &currentWave, sizeof(currentWave));
+        hash = hashBytes(hash, &elapsedTime, sizeof(elapsedTime));
+        hash = playerBullets.checksum(hash);
+        hash = meteors.checksum(hash);
+        hash = enemyBullets.checksum(hash);
+
+        for (int i = 0; i < enemyPool->getActiveCount(); i++) {
+            sf::FloatRect bounds = enemyPool->getActive(i)->getBounds();
+            hash = hashBytes(hash, &bounds, sizeof(bounds));
+        }
+        for (int i = 0; i < 10; i++) {
+            if (powerups[i].isActive()) {
+                sf::FloatRect bounds = powerups[i].getBounds();
+                hash = hashBytes(hash, &bounds, sizeof(bounds));
+            }
+        }
+        if (bossEnemy != nullptr && bossEnemy->isActive()) {
+            sf::FloatRect bounds = bossEnemy->getBounds();
+            hash = hashBytes(hash, &bounds, sizeof(bounds));
+        }
+        return hash;
+    }
+
+    ReplaySettings currentReplaySettings() const {
+        ReplaySettings current;
+        current.seed = levelSeed;
+        current.meteorInterval = meteorSpawnInterval;
+        current.enemyInterval = enemySpawnInterval;
+        current.playerSpeed = speed;
+        current.enemyColor = enemyColor;
+        current.waves = maxWaves;
+        current.scoreOffset = scoreOffset;
+        current.startTime = elapsedTime;
+        current.timerRunning = timerRunning;
+        return current;
+    }
+
+    /// purpose: log every session from the next reset() on, each with a fresh level seed.
+    void setRecording(bool enabled) {
+        recordingReplay = enabled;
+    }
+
+    /// return: false if nothing was recorded yet or the file cannot be written.
+    bool saveReplay(const string& path) const {
+        if (!recordingReplay || playingReplay || replay.getTickCount() == 0) return false;
+        return replay.saveToFile(path);
+    }
+
+    /// purpose: load a recorded session and restart the level exactly as it began; update() then feeds the
+    ///          recorded input until isReplayFinished(). stopReplay() restores the previous difficulty.
+    bool startReplay(const string& path) {
+        if (!replay.loadFromFile(path)) return false;
+
+        if (!playingReplay) settingsBeforeReplay = currentReplaySettings();
+        const ReplaySettings& recorded = replay.getSettings();
+        configureDifficulty(recorded.meteorInterval, recorded.enemyInterval, recorded.playerSpeed, recorded.enemyColor, recorded.waves);
+
+        playingReplay = true;
+        reset();
+        setScoreOffset(recorded.scoreOffset);
+        timerRunning = recorded.timerRunning;
+        elapsedTime = recorded.startTime;
+        return true;
+    }
+
+    void stopReplay() {
+        if (!playingReplay) return;
+
+        playingReplay = false;
+        configureDifficulty(settingsBeforeReplay.meteorInterval, settingsBeforeReplay.enemyInterval,
+            settingsBeforeReplay.playerSpeed, settingsBeforeReplay.enemyColor, settingsBeforeReplay.waves);
+        reset();
+    }
+
+    bool isPlayingReplay() const { return playingReplay; }
+    bool isReplayFinished() const { return playingReplay && replayTick >= replay.getTickCount(); }
+    long getReplayTick() const { return replayTick; }
+    long getReplayLength() const { return replay.getTickCount(); }
+
+    /// return: first tick whose state differed from the recording, or -1 while playback matches.
+    long getReplayDivergence() const { return replayDivergedAt; }
+
+    /// purpose: stress hook for benchmarks; grows the projectile fields if needed and scatters the given number
+    ///          of player bullets, meteors and enemy bullets across the screen, replacing the current ones.
+    ///          The layout depends only on seed, so runs are comparable.
+    void spawnStressEntities(int bulletCount, int meteorCount, int enemyBulletCount, unsigned int seed) {
+        RandomStream random(seed);
+        playerBullets.reserve(bulletCount);
+        meteors.reserve(meteorCount);
+        enemyBullets.reserve(enemyBulletCount);
+        playerBullets.clear();
+        meteors.clear();
+        enemyBullets.clear();
+
+        for (int i = 0; i < bulletCount; i++) {
+            playerBullets.spawn((float)random.below(screenW), (float)random.below(screenH), 0.0f, -800.0f);
+        }
+        for (int i = 0; i < meteorCount; i++) {
+            int type = random.below(2);
+            meteors.spawn((float)random.below(screenW), (float)random.below(screenH), 0.0f, 150.0f + random.below(100),
+                (float)random.below(360), 0.0f, type);
+        }
+        for (int i = 0; i < enemyBulletCount; i++) {
+            enemyBullets.spawn((float)random.below(screenW), (float)random.below(screenH), 0.0f, 300.0f);
+        }
+    }
+
+    /// purpose: cache this tick's bounds of everything the player or their bullets can hit; run after all movement.
+    void buildCollisionGrid() {
+        collisionGrid.clear();
+        for (int i = 0; i < meteors.getCount(); i++) {
+            if (meteors.isActive(i) && !meteors.isExploding(i)) {
+                collisionGrid.insert(meteors.getBounds(i), GRID_METEOR, i);
+            }
+        }
+        for (int i = 0; i < enemyPool->getActiveCount(); i++) {
+            collisionGrid.insert(enemyPool->getActive(i)->getBounds(), GRID_ENEMY, i);
+        }
+        for (int i = 0; i < enemyBullets.getCount(); i++) {
+            if (enemyBullets.isActive(i)) {
+                collisionGrid.insert(enemyBullets.getBounds(i), GRID_ENEMY_BULLET, i);
+            }
+        }
+        for (int i = 0; i < 10; i++) {
+            if (powerups[i].isActive()) {
+                collisionGrid.insert(powerups[i].getBounds(), GRID_POWERUP, i);
+            }
+        }
+    }
     float getCurrentTime() const {
         return elapsedTime;
     }
 
-    void handleShooting() {
-        bool spacePressed = sf::Keyboard::isKeyPressed(sf::Keyboard::Space);
+    /// purpose: snapshot every entity's position before a tick so draw can interpolate towards the new one.
+    void storePreviousPositions() {
+        previousPlayerPosition = player.getPosition();
+        playerBullets.storePreviousPositions();
+        meteors.storePreviousPositions();
+        enemyBullets.storePreviousPositions();
+        for (int i = 0; i < enemyPool->getActiveCount(); i++) {
+            enemyPool->getActive(i)->storePreviousPosition();
+        }
+        for (int i = 0; i < 10; i++) {
+            powerups[i].storePreviousPosition();
+        }
+        if (bossEnemy != nullptr) bossEnemy->storePreviousPosition();
+    }
+
+    void handleShooting(const PlayerInput& input) {
+        bool spacePressed = input.fire;
 
 
         if (spacePressed && !spaceWasPressed) {
             if (hasDoubleFire) {
 
-                int bulletsFired = 0;
-                for (int i = 0; i < 20 && bulletsFired < 2; i++) {
-                    if (!bulletPool->get(i)->isActive()) {
-                        float rotationDegrees = player.getRotation();
-                        float rotationRadians = rotationDegrees * 3.14159265f / 180.0f;
+                for (int bulletsFired = 0; bulletsFired < 2; bulletsFired++) {
+                    float rotationDegrees = player.getRotation();
+                    float rotationRadians = rotationDegrees * 3.14159265f / 180.0f;
 
-                        sf::FloatRect playerBounds = player.getLocalBounds();
-                        float noseOffset = playerBounds.height / 2.0f;
+                    sf::FloatRect playerBounds = player.getLocalBounds();
+                    float noseOffset = playerBounds.height / 2.0f;
 
 
-                        float sideOffset = (bulletsFired == 0) ? -15.0f : 15.0f;
+                    float sideOffset = (bulletsFired == 0) ? -15.0f : 15.0f;
 
-                        sf::Vector2f playerPos = player.getPosition();
-                        float noseX = playerPos.x + noseOffset * std::sin(rotationRadians) + sideOffset * std::cos(rotationRadians);
-                        float noseY = playerPos.y - noseOffset * std::cos(rotationRadians) + sideOffset * std::sin(rotationRadians);
+                    sf::Vector2f playerPos = player.getPosition();
+                    float noseX = playerPos.x + noseOffset * std::sin(rotationRadians) + sideOffset * std::cos(rotationRadians);
+                    float noseY = playerPos.y - noseOffset * std::cos(rotationRadians) + sideOffset * std::sin(rotationRadians);
 
-                        bulletPool->get(i)->fire(sf::Vector2f(noseX, noseY), rotationDegrees);
-                        bulletsFired++;
-                    }
+                    fireBullet(noseX, noseY, rotationDegrees);
                 }
 
                 if (soundLoaded) laserSound.play();
             }
             else {
 
-                for (int i = 0; i < 20; i++) {
-                    if (!bulletPool->get(i)->isActive()) {
-                        float rotationDegrees = player.getRotation();
-                        float rotationRadians = rotationDegrees * 3.14159265f / 180.0f;
-
-                        sf::FloatRect playerBounds = player.getLocalBounds();
-                        float noseOffset = playerBounds.height / 2.0f;
+                float rotationDegrees = player.getRotation();
+                float rotationRadians = rotationDegrees * 3.14159265f / 180.0f;
 
-                        sf::Vector2f playerPos = player.getPosition();
-                        float noseX = playerPos.x + noseOffset * std::sin(rotationRadians);
-                        float noseY = playerPos.y - noseOffset * std::cos(rotationRadians);
+                sf::FloatRect playerBounds = player.getLocalBounds();
+                float noseOffset = playerBounds.height / 2.0f;
 
-                        bulletPool->get(i)->fire(sf::Vector2f(noseX, noseY), rotationDegrees);
+                sf::Vector2f playerPos = player.getPosition();
+                float noseX = playerPos.x + noseOffset * std::sin(rotationRadians);
+                float noseY = playerPos.y - noseOffset * std::cos(rotationRadians);
 
-                        if (soundLoaded) laserSound.play();
-                        break;
-                    }
+                if (fireBullet(noseX, noseY, rotationDegrees)) {
+                    if (soundLoaded) laserSound.play();
                 }
             }
         }
@@ -2839,61 +5398,71 @@ public:
         spaceWasPressed = spacePressed;
     }
 
+    /// return: false when all 20 player bullets are already in flight.
+    bool fireBullet(float x, float y, float rotationDegrees) {
+        float rotationRadians = rotationDegrees * 3.14159265f / 180.0f;
+        float bulletSpeed = 800.0f;
+        return playerBullets.spawn(x, y, std::sin(rotationRadians) * bulletSpeed, -std::cos(rotationRadians) * bulletSpeed, rotationDegrees) >= 0;
+    }
+
     void updateBullets(float dt) {
-        for (int i = 0; i < 20; i++) {
-            bulletPool->get(i)->update(dt);
-        }
+        playerBullets.integrate(dt);
+        playerBullets.compact();
     }
 
     void spawnMeteors() {
+        PROFILE_ZONE(PROFILE_SPAWN);
 
-        if (meteorSpawnTimer.getElapsedTime().asSeconds() >= meteorSpawnInterval) {
+        if (meteorSpawnTimer.getElapsedSeconds() >= meteorSpawnInterval) {
 
-            for (int i = 0; i < 20; i++) {
-                if (!meteors[i].isActive()) {
-                    meteors[i].spawn((float)screenW);
-                    meteorSpawnTimer.restart();
-                    break;
-                }
+            if (meteors.getCount() < meteors.getCapacity()) {
+                float randomX = (float)meteorRandom.below(screenW);
+                int type = meteorRandom.below(2);
+                float meteorSpeed = (type == METEOR_BIG) ? 150.0f + meteorRandom.below(50) : 250.0f + meteorRandom.below(100);
+                float rotationDegrees = (float)meteorRandom.below(360);
+
+                meteors.spawn(randomX, -100.0f, 0.0f, meteorSpeed, rotationDegrees, 30.0f, type);
+                meteorSpawnTimer.restart();
             }
         }
     }
 
     void updateMeteors(float dt) {
-        for (int i = 0; i < 20; i++) {
-            meteors[i].update(dt);
+        PROFILE_ZONE(PROFILE_METEORS);
+        meteors.integrate(dt);
+
+
+        for (int i = 0; i < meteors.getCount(); i++) {
+            if (meteors.isExploding(i) && meteors.getTimer(i) > 0.2f) {
+                meteors.kill(i);
+            }
         }
+        meteors.compact();
     }
 
     void checkBulletMeteorCollisions() {
 
-        for (int i = 0; i < 20; i++) {
-            if (!bulletPool->get(i)->isActive()) continue;
-
-            sf::FloatRect bulletBounds = bulletPool->get(i)->getBounds();
-
-            for (int j = 0; j < 20; j++) {
-                if (!meteors[j].isActive() || meteors[j].getIsExploding()) continue;
-
-                sf::FloatRect meteorBounds = meteors[j].getBounds();
-
-
-                if (bulletBounds.intersects(meteorBounds)) {
+        for (int i = 0; i < playerBullets.getCount(); i++) {
+            if (!playerBullets.isActive(i)) continue;
 
-                    bulletPool->get(i)->deactivate();
-                    meteors[j].takeDamage();
+            int hits = collisionGrid.query(playerBullets.getBounds(i), GRID_METEOR, gridResults, 64);
+            for (int k = 0; k < hits; k++) {
+                int j = gridResults[k];
+                if (!meteors.isActive(j) || meteors.isExploding(j)) continue;
 
+                int type = meteors.getKind(j);
+                playerBullets.kill(i);
+                meteors.explode(j, METEOR_EXPLOSION);
 
-                    if (meteors[j].getType() == 1) {
-                        score += 20;
-                    }
-                    else {
-                        score += 10;
-                    }
-                    updateScoreDisplay();
 
-                    break;
+                if (type == METEOR_BIG) {
+                    score += 20;
                 }
+                else {
+                    score += 10;
+                }
+
+                break;
             }
         }
     }
@@ -2901,41 +5470,35 @@ public:
     void checkPlayerMeteorCollisions() {
         if (isDestroyed) return;
 
-        sf::FloatRect playerBounds = player.getGlobalBounds();
-
-        for (int i = 0; i < 20; i++) {
-            if (!meteors[i].isActive() || meteors[i].getIsExploding()) continue;
-
-            sf::FloatRect meteorBounds = meteors[i].getBounds();
-
+        int hits = collisionGrid.query(player.getGlobalBounds(), GRID_METEOR, gridResults, 64);
+        for (int k = 0; k < hits; k++) {
+            int i = gridResults[k];
+            if (!meteors.isActive(i) || meteors.isExploding(i)) continue;
 
-            if (playerBounds.intersects(meteorBounds)) {
-
-                loseLife();
-                meteors[i].takeDamage();
-                break;
-            }
+            loseLife();
+            meteors.explode(i, METEOR_EXPLOSION);
+            break;
         }
     }
 
     void loseLife() {
         lives--;
-        updateLivesDisplay();
 
         if (lives <= 0) {
 
             isDestroyed = true;
             timerRunning = false;
-            player.setTexture(playerDestroyedTexture);
-            cout << "GAME OVER! Final Score: " << score << endl;
-            cout << "Press R to restart or ESC for main menu" << endl;
+            playerDestroyedTexture.applyTo(player);
+            gameLog() << "GAME OVER! Final Score: " << score << endl;
+            gameLog() << "Press R to restart or ESC for main menu" << endl;
         }
         else {
 
             player.setPosition((float)screenW / 2.0f, (float)screenH - 250.0f);
             player.setRotation(0.0f);
+            previousPlayerPosition = player.getPosition();
             tiltAngle = 0.0f;
-            cout << "Lives remaining: " << lives << endl;
+            gameLog() << "Lives remaining: " << lives << endl;
         }
     }
     void stopTimer() {
@@ -2947,11 +5510,12 @@ public:
     }
 
     void spawnPowerUps() {
-        if (powerUpSpawnTimer.getElapsedTime().asSeconds() >= powerUpSpawnInterval) {
+        PROFILE_ZONE(PROFILE_SPAWN);
+        if (powerUpSpawnTimer.getElapsedSeconds() >= powerUpSpawnInterval) {
             for (int i = 0; i < 10; i++) {
                 if (!powerups[i].isActive()) {
-                    float x = (float)(rand() % screenW);
-                    int type = rand() % 4;
+                    float x = (float)powerUpRandom.below(screenW);
+                    int type = powerUpRandom.below(4);
                     powerups[i].spawn(x, type);
                     powerUpSpawnTimer.restart();
                     break;
@@ -2967,60 +5531,57 @@ public:
     }
 
     void checkPowerUpCollisions() {
-        sf::FloatRect playerBounds = player.getGlobalBounds();
-
-        for (int i = 0; i < 10; i++) {
+        int hits = collisionGrid.query(player.getGlobalBounds(), GRID_POWERUP, gridResults, 64);
+        for (int k = 0; k < hits; k++) {
+            int i = gridResults[k];
             if (!powerups[i].isActive()) continue;
 
-            if (playerBounds.intersects(powerups[i].getBounds())) {
-                int type = powerups[i].getType();
-
-                switch (type) {
-                case 0:
-                    hasDoubleFire = true;
-                    doubleFireTimer = 10.0f;
-                    cout << "Double Fire activated!" << endl;
-                    powerUpFlashColor = sf::Color(255, 150, 50, 100);
-                    showPowerUpFlash = true;
-                    powerUpFlashTimer.restart();
-                    break;
+            int type = powerups[i].getType();
 
-                case 1:
-                    hasShield = true;
-                    shieldTimer = 10.0f;
-                    cout << "Shield activated!" << endl;
-                    powerUpFlashColor = sf::Color(50, 255, 100, 100);
-                    showPowerUpFlash = true;
-                    powerUpFlashTimer.restart();
-                    break;
+            switch (type) {
+            case 0:
+                hasDoubleFire = true;
+                doubleFireTimer = 10.0f;
+                gameLog() << "Double Fire activated!" << endl;
+                powerUpFlashColor = sf::Color(255, 150, 50, 100);
+                showPowerUpFlash = true;
+                powerUpFlashTimer.restart();
+                break;
 
-                case 2:
-                    if (lives < 3) {
-                        lives++;
-                        updateLivesDisplay();
-                        cout << "Life restored! Lives: " << lives << endl;
-                        powerUpFlashColor = sf::Color(100, 150, 255, 100);
-                        showPowerUpFlash = true;
-                        powerUpFlashTimer.restart();
-                    }
-                    break;
+            case 1:
+                hasShield = true;
+                shieldTimer = 10.0f;
+                gameLog() << "Shield activated!" << endl;
+                powerUpFlashColor = sf::Color(50, 255, 100, 100);
+                showPowerUpFlash = true;
+                powerUpFlashTimer.restart();
+                break;
 
-                case 3:
-                    score += 50;
-                    updateScoreDisplay();
-                    cout << "Score boost! +50 points. Total: " << score << endl;
-                    powerUpFlashColor = sf::Color(255, 215, 0, 100);
+            case 2:
+                if (lives < 3) {
+                    lives++;
+                    gameLog() << "Life restored! Lives: " << lives << endl;
+                    powerUpFlashColor = sf::Color(100, 150, 255, 100);
                     showPowerUpFlash = true;
                     powerUpFlashTimer.restart();
-                    break;
                 }
+                break;
 
-                powerups[i].deactivate();
+            case 3:
+                score += 50;
+                gameLog() << "Score boost! +50 points. Total: " << score << endl;
+                powerUpFlashColor = sf::Color(255, 215, 0, 100);
+                showPowerUpFlash = true;
+                powerUpFlashTimer.restart();
+                break;
             }
+
+            powerups[i].deactivate();
         }
     }
 
     void spawnEnemies() {
+        PROFILE_ZONE(PROFILE_SPAWN);
 
         if (currentWave == 0 && !waveInProgress) {
             startNewWave();
@@ -3036,13 +5597,13 @@ public:
                 allWaveEnemiesCleared = true;
                 waveInProgress = false;
                 waveDelayTimer.restart();
-                cout << "Wave " << currentWave << " cleared! Waiting for next wave..." << endl;
+                gameLog() << "Wave " << currentWave << " cleared! Waiting for next wave..." << endl;
             }
         }
 
 
         if (!waveInProgress && allWaveEnemiesCleared && currentWave < maxWaves) {
-            if (waveDelayTimer.getElapsedTime().asSeconds() >= waveDelay) {
+            if (waveDelayTimer.getElapsedSeconds() >= waveDelay) {
                 startNewWave();
             }
             return;
@@ -3060,65 +5621,57 @@ public:
 
 
 
-        if (enemySpawnTimer.getElapsedTime().asSeconds() >= enemySpawnInterval) {
+        if (enemySpawnTimer.getElapsedSeconds() >= enemySpawnInterval) {
             if (isBossWave) {
 
                 if (bossEnemy == nullptr && enemiesSpawnedInWave == 0) {
-                    bossEnemy = new BossEnemy("Black", 50.0f);
-                    bossEnemy->setScreenSize(screenW, screenH);
+                    bossEnemy = &bossInstance;
                     bossEnemy->spawn(screenW * 0.5f, 100.0f);
                     enemiesSpawnedInWave++;
                     enemySpawnTimer.restart();
-                    cout << "BOSS SPAWNED!" << endl;
+                    gameLog() << "BOSS SPAWNED!" << endl;
                 }
             }
             else {
 
-                for (int i = 0; i < 10; i++) {
-                    if (enemies[i] == 0 || !enemies[i]->isActive()) {
-                        if (enemies[i] != 0) {
-                            delete enemies[i];
-                        }
-
-                        float enemySpeed = (maxWaves == 3) ? 120.0f : 80.0f;
+                EnemyLevel1* enemy = enemyPool->resolve(enemyPool->acquire());
+                if (enemy != nullptr) {
+                    float enemySpeed = (maxWaves == 3) ? 120.0f : 80.0f;
 
 
-                        int movementPattern = 0;
-                        if (maxWaves == 3 && enemyColor == "Green") {
-                            if (currentWave == 1) {
-                                movementPattern = 1;
-                            }
-                            else if (currentWave == 2) {
-                                movementPattern = 2;
-                            }
+                    int movementPattern = 0;
+                    if (maxWaves == 3 && enemyColor == "Green") {
+                        if (currentWave == 1) {
+                            movementPattern = 1;
                         }
+                        else if (currentWave == 2) {
+                            movementPattern = 2;
+                        }
+                    }
 
-                        enemies[i] = new EnemyLevel1(enemyColor, enemySpeed, movementPattern);
-                        enemies[i]->setScreenSize(screenW, screenH);
-
+                    enemy->setMovement(enemySpeed, movementPattern);
 
-                        float spawnX = 0.0f, spawnY = -50.0f;
-                        if (maxWaves == 3 && enemyColor == "Green" && currentWave <= 2) {
 
-                            if (currentFormation.getNextPosition(spawnX, spawnY)) {
-                                enemies[i]->spawn(spawnX, spawnY);
-                            }
-                            else {
+                    float spawnX = 0.0f, spawnY = -50.0f;
+                    if (maxWaves == 3 && enemyColor == "Green" && currentWave <= 2) {
 
-                                float randomX = (float)(rand() % screenW);
-                                enemies[i]->spawn(randomX, -50.0f);
-                            }
+                        if (currentFormation.getNextPosition(spawnX, spawnY)) {
+                            enemy->spawn(spawnX, spawnY);
                         }
                         else {
 
-                            float randomX = (float)(rand() % screenW);
-                            enemies[i]->spawn(randomX, -50.0f);
+                            float randomX = (float)waveRandom.below(screenW);
+                            enemy->spawn(randomX, -50.0f);
                         }
+                    }
+                    else {
 
-                        enemiesSpawnedInWave++;
-                        enemySpawnTimer.restart();
-                        break;
+                        float randomX = (float)waveRandom.below(screenW);
+                        enemy->spawn(randomX, -50.0f);
                     }
+
+                    enemiesSpawnedInWave++;
+                    enemySpawnTimer.restart();
                 }
             }
         }
@@ -3133,11 +5686,7 @@ public:
         }
 
 
-        for (int i = 0; i < 10; i++) {
-            if (enemies[i] != 0 && enemies[i]->isActive()) {
-                activeEnemiesCount++;
-            }
-        }
+        activeEnemiesCount += enemyPool->getActiveCount();
     }
 
     void startNewWave() {
@@ -3151,7 +5700,7 @@ public:
 
             isBossWave = true;
             enemiesPerWave = 1;
-            cout << "BOSS WAVE! Prepare for battle!" << endl;
+            gameLog() << "BOSS WAVE! Prepare for battle!" << endl;
         }
         else {
             isBossWave = false;
@@ -3159,36 +5708,36 @@ public:
 
             if (maxWaves == 2) {
                 if (currentWave == 1) {
-                    enemiesPerWave = 5 + (rand() % 2);
+                    enemiesPerWave = 5 + waveRandom.below(2);
                 }
                 else if (currentWave == 2) {
-                    enemiesPerWave = 7 + (rand() % 2);
+                    enemiesPerWave = 7 + waveRandom.below(2);
                 }
             }
             else if (maxWaves == 3 && enemyColor != "Green") {
                 if (currentWave == 1) {
-                    enemiesPerWave = 5 + (rand() % 2);
+                    enemiesPerWave = 5 + waveRandom.below(2);
                 }
                 else if (currentWave == 2) {
-                    enemiesPerWave = 7 + (rand() % 2);
+                    enemiesPerWave = 7 + waveRandom.below(2);
                 }
                 else if (currentWave == 3) {
-                    enemiesPerWave = 10 + (rand() % 3);
+                    enemiesPerWave = 10 + waveRandom.below(3);
                 }
             }
             else if (maxWaves == 3 && enemyColor == "Green") {
                 if (currentWave == 1) {
-                    enemiesPerWave = 6 + (rand() % 2);
+                    enemiesPerWave = 6 + waveRandom.below(2);
                     currentFormation.createVFormation(screenW * 0.5f, -100.0f, enemiesPerWave);
                 }
                 else if (currentWave == 2) {
-                    enemiesPerWave = 8 + (rand() % 2);
+                    enemiesPerWave = 8 + waveRandom.below(2);
                     currentFormation.createTriangleFormation(screenW * 0.5f, -100.0f, enemiesPerWave);
                 }
             }
         }
 
-        cout << "Wave " << currentWave << " started! Enemies: " << enemiesPerWave << endl;
+        gameLog() << "Wave " << currentWave << " started! Enemies: " << enemiesPerWave << endl;
 
 
         showWaveAnnouncement();
@@ -3196,69 +5745,75 @@ public:
         enemySpawnTimer.restart();
     }
 
+    /// purpose: start the wave banner. Only its text is kept here, since ticks may run on the simulation thread;
+    ///          the banner is laid out with waveFont when a snapshot is drawn.
     void showWaveAnnouncement() {
-        string message;
         if (isBossWave) {
-            message = "BOSS INCOMING!";
-            waveAnnouncement.setup(message, waveFont, 64, sf::Color::Red);
+            waveMessage = "BOSS INCOMING!";
         }
         else {
-            message = "WAVE " + std::to_string(currentWave) + " INCOMING!";
-            waveAnnouncement.setup(message, waveFont, 64, sf::Color::Yellow);
+            waveMessage = "WAVE " + std::to_string(currentWave) + " INCOMING!";
         }
-        waveAnnouncement.setPosition((float)screenW * 0.5f, (float)screenH * 0.5f);
-        waveAnnouncement.start();
+        waveShown = "";
+        waveTypeTimer = 0.0f;
         showingWaveAnnouncement = true;
         waveAnnouncementTimer.restart();
     }
 
+    /// purpose: typewriter effect for the wave banner, one more character every waveTypeInterval seconds.
+    void typeWaveAnnouncement(float dt) {
+        waveTypeTimer += dt;
+        if (waveTypeTimer >= waveTypeInterval) {
+            waveTypeTimer = 0.0f;
+            if (waveShown.length() < waveMessage.length()) {
+                waveShown += waveMessage[waveShown.length()];
+            }
+        }
+    }
+
 
     void updateEnemies(float dt) {
+        PROFILE_ZONE(PROFILE_ENEMIES);
 
         if (bossEnemy != nullptr && bossEnemy->isActive()) {
             bossEnemy->update(dt);
 
-
-            BossEnemy* boss = dynamic_cast<BossEnemy*>(bossEnemy);
-            if (boss && boss->shouldShoot()) {
-                boss->shoot(enemyBullets, 50);
+            if (bossEnemy->shouldShoot()) {
+                bossEnemy->shoot(enemyBullets);
             }
         }
 
 
-        for (int i = 0; i < 10; i++) {
-            if (enemies[i] != 0 && enemies[i]->isActive()) {
-                enemies[i]->update(dt);
+        for (int i = 0; i < enemyPool->getActiveCount(); i++) {
+            EnemyLevel1* enemy = enemyPool->getActive(i);
+            enemy->update(dt);
 
-                EnemyLevel1* enemy1 = dynamic_cast<EnemyLevel1*>(enemies[i]);
-                if (enemy1 && enemy1->shouldShoot()) {
-                    enemy1->shoot(enemyBullets, 50);
-                }
+            if (enemy->isActive() && enemy->shouldShoot()) {
+                enemy->shoot(enemyBullets);
             }
         }
+        enemyPool->collectInactive();
     }
 
     void updateEnemyBullets(float dt) {
-        for (int i = 0; i < 50; i++) {
-            enemyBullets[i].update(dt);
-        }
+        enemyBullets.integrate(dt);
+        enemyBullets.compact();
     }
 
     void checkBulletEnemyCollisions() {
 
         if (bossEnemy != nullptr && bossEnemy->isActive()) {
-            for (int i = 0; i < 20; i++) {
-                if (!bulletPool->get(i)->isActive()) continue;
+            for (int i = 0; i < playerBullets.getCount(); i++) {
+                if (!playerBullets.isActive(i)) continue;
 
-                if (bulletPool->get(i)->getBounds().intersects(bossEnemy->getBounds())) {
+                if (playerBullets.getBounds(i).intersects(bossEnemy->getBounds())) {
                     bossEnemy->takeDamage();
-                    bulletPool->get(i)->deactivate();
+                    playerBullets.kill(i);
 
                     score += 10;
-                    updateScoreDisplay();
 
                     if (!bossEnemy->isActive()) {
-                        cout << "BOSS DEFEATED!" << endl;
+                        gameLog() << "BOSS DEFEATED!" << endl;
                     }
                     break;
                 }
@@ -3266,285 +5821,582 @@ public:
         }
 
 
-        for (int i = 0; i < 20; i++) {
-            if (!bulletPool->get(i)->isActive()) continue;
+        for (int i = 0; i < playerBullets.getCount(); i++) {
+            if (!playerBullets.isActive(i)) continue;
 
-            for (int j = 0; j < 10; j++) {
-                if (enemies[j] == 0 || !enemies[j]->isActive()) continue;
+            int hits = collisionGrid.query(playerBullets.getBounds(i), GRID_ENEMY, gridResults, 64);
+            for (int k = 0; k < hits; k++) {
+                EnemyLevel1* enemy = enemyPool->getActive(gridResults[k]);
+                if (!enemy->isActive()) continue;
 
-                if (bulletPool->get(i)->getBounds().intersects(enemies[j]->getBounds())) {
-                    enemies[j]->takeDamage();
-                    bulletPool->get(i)->deactivate();
+                enemy->takeDamage();
+                playerBullets.kill(i);
 
-                    score += 10;
-                    updateScoreDisplay();
-                    break;
-                }
+                score += 10;
+                break;
             }
         }
+        enemyPool->collectInactive();
     }
 
     void checkPlayerEnemyBulletCollisions() {
         if (hasShield) return;
 
-        sf::FloatRect playerBounds = player.getGlobalBounds();
+        int hits = collisionGrid.query(player.getGlobalBounds(), GRID_ENEMY_BULLET, gridResults, 64);
+        for (int k = 0; k < hits; k++) {
+            int i = gridResults[k];
+            if (!enemyBullets.isActive(i)) continue;
 
-        for (int i = 0; i < 50; i++) {
-            if (!enemyBullets[i].isActive()) continue;
-
-            if (playerBounds.intersects(enemyBullets[i].getBounds())) {
-                loseLife();
-                enemyBullets[i].deactivate();
-                break;
-            }
+            loseLife();
+            enemyBullets.kill(i);
+            break;
         }
     }
 
-    void updateLivesDisplay() {
-        if (lives >= 0 && lives <= 9) {
-            lifeCountSprite.setTexture(numeralTextures[lives]);
-        }
+    bool isPlayerDestroyed() const {
+        return isDestroyed;
     }
 
-    void updateScoreDisplay() {
+    int getScore() const {
+        return score;
+    }
 
-        int displayScore = score + scoreOffset;
-        string scoreStr = std::to_string(displayScore);
+    sf::Vector2f getPlayerPosition() const {
+        return player.getPosition();
+    }
 
+    /// purpose: the level as it stands after the last tick, for drawing later or on another thread. Reads the
+    ///          simulation but changes nothing it depends on, so the simulation thread records while the main one draws.
+    void recordSnapshot(LevelSnapshot& snapshot) {
+        for (int pass = 0; pass < 2; pass++) {
+            float alpha = (float)pass;
+            snapshot.layerCount = 0;
+            batch.beginRecording(snapshot.layers, snapshot.layerCount, pass == 1);
 
-        for (int i = 0; i < 6; i++) {
-            scoreDigits[i].setScale(0.0f, 0.0f);
-        }
+            batch.add(bgSprite);
+            batch.flush();
+            meteors.draw(batch, alpha);
+            batch.flush();
+            for (int i = 0; i < 10; i++) {
+                powerups[i].draw(batch, alpha);
+            }
+            batch.flush();
+            if (bossEnemy != nullptr && bossEnemy->isActive()) {
+                bossEnemy->draw(batch, alpha);
+                batch.flush();
+            }
+            for (int i = 0; i < enemyPool->getActiveCount(); i++) {
+                enemyPool->getActive(i)->draw(batch, alpha);
+            }
+            batch.flush();
+            enemyBullets.draw(batch, alpha);
+            batch.flush();
 
+            sf::Transform playerOffset = interpolatedStates(previousPlayerPosition, player.getPosition(), alpha).transform;
+            if (hasShield) {
+                shieldSprite.setPosition(player.getPosition());
+                shieldSprite.setRotation(player.getRotation());
+                batch.add(shieldSprite, playerOffset);
+            }
+            batch.add(player, playerOffset);
+            batch.flush();
+            playerBullets.draw(batch, alpha);
+            batch.flush();
 
-        int numDigits = (int)scoreStr.length();
-        if (numDigits > 6) numDigits = 6;
+            if (showPowerUpFlash) {
+                batch.addRect(sf::FloatRect(0.0f, 0.0f, (float)screenW, (float)screenH), powerUpFlash.getFillColor());
+                batch.flush();
+            }
+        }
 
-        float digitSpacing = 50.0f;
-        float totalWidth = (numDigits - 1) * digitSpacing;
+        snapshot.level = this;
+        snapshot.generation = generation;
+        snapshot.score = score + scoreOffset;
+        snapshot.lives = lives;
+        snapshot.elapsedTime = elapsedTime;
+        snapshot.timerVisible = timerRunning || isDestroyed;
+        snapshot.hasDoubleFire = hasDoubleFire;
+        snapshot.doubleFireTimer = doubleFireTimer;
+        snapshot.hasShield = hasShield;
+        snapshot.shieldTimer = shieldTimer;
+        snapshot.showWave = showingWaveAnnouncement;
+        snapshot.waveText = waveShown;
+        snapshot.waveColor = isBossWave ? sf::Color::Red : sf::Color::Yellow;
+    }
 
+    /// return: true while the snapshot was taken from this level since its last reset().
+    bool isSnapshotOf(const LevelSnapshot& snapshot) const {
+        return snapshot.level == this && snapshot.generation == generation;
+    }
 
-        float startX = (float)screenW - 60.0f - totalWidth;
+    /// purpose: draw a recorded snapshot; alpha (0..1) moves every layer between the last two ticks. Only touches the
+    ///          hud and draw-side members, so it may run while the simulation thread ticks this level.
+    void drawSnapshot(sf::RenderWindow& window, const LevelSnapshot& snapshot, float alpha) {
+        PROFILE_ZONE(PROFILE_LEVEL_DRAW);
+        submitSnapshot(window, snapshot, alpha);
+    }
 
+    /// purpose: render the level; alpha (0..1) interpolates moving entities between the last two simulation ticks.
+    void draw(sf::RenderWindow& window, float alpha = 1.0f) {
+        PROFILE_ZONE(PROFILE_LEVEL_DRAW);
+        recordSnapshot(liveSnapshot);
+        submitSnapshot(window, liveSnapshot, alpha);
+    }
 
-        for (int i = 0; i < numDigits; i++) {
-            int digit = scoreStr[i] - '0';
+private:
+    void submitSnapshot(sf::RenderWindow& window, const LevelSnapshot& snapshot, float alpha) {
+        for (int i = 0; i < snapshot.layerCount; i++) {
+            const SnapshotLayer& layer = snapshot.layers[i];
+            size_t count = layer.to.getVertexCount();
+            bool paired = (layer.from.getVertexCount() == count);
+
+            snapshotVertices.resize(count);
+            for (size_t v = 0; v < count; v++) {
+                sf::Vertex vertex = layer.to[v];
+                if (paired) {
+                    vertex.position = layer.from[v].position + (vertex.position - layer.from[v].position) * alpha;
+                }
+                snapshotVertices[v] = vertex;
+            }
 
-            scoreDigits[i].setTexture(numeralTextures[digit]);
-            scoreDigits[i].setScale(1.8f, 1.8f);
-            scoreDigits[i].setPosition(startX + i * digitSpacing, 20.0f);
+            sf::RenderStates states;
+            states.texture = layer.texture;
+            countedDraw(window, snapshotVertices, states);
         }
-    }
 
-    void updateTimerDisplay() {
-
-        int totalSeconds = (int)elapsedTime;
-        int minutes = totalSeconds / 60;
-        int seconds = totalSeconds % 60;
 
+        hud.setScore(snapshot.score);
+        hud.setLives(snapshot.lives);
+        hud.setTimer(snapshot.elapsedTime, snapshot.timerVisible);
+        hud.setPowerUps(snapshot.hasDoubleFire, snapshot.doubleFireTimer, snapshot.hasShield, snapshot.shieldTimer);
+        hud.draw(window);
 
-        if (minutes > 99) minutes = 99;
 
+        if (snapshot.showWave) {
+            waveText.setFont(waveFont);
+            waveText.setCharacterSize(64);
+            waveText.setFillColor(snapshot.waveColor);
+            waveText.setString(snapshot.waveText);
+            sf::FloatRect b = waveText.getLocalBounds();
+            waveText.setOrigin(b.left + b.width / 2.0f, b.top + b.height / 2.0f);
+            waveText.setPosition((float)screenW * 0.5f, (float)screenH * 0.5f);
+            window.draw(waveText);
+        }
+    }
+};
 
-        float centerX = (float)screenW * 0.5f;
-        float startY = 20.0f;
-        float digitSpacing = 40.0f;
 
 
-        int minute1 = minutes / 10;
-        int minute2 = minutes % 10;
 
+/// fixed gameplay tick (120 hz) shared by the windowed loop and headless runs, so outcomes do not depend on frame rate.
+const float SIMULATION_DT = 1.0f / 120.0f;
+/// longest frame the windowed loop will catch up on; anything slower runs in slow motion instead of spiralling.
+const float MAX_FRAME_DT = 0.25f;
+const long MAX_SIMULATED_LEVEL_TICKS = 120L * 60L * 10L;
 
-        int second1 = seconds / 10;
-        int second2 = seconds % 10;
+const int SIM_VICTORY = 0;
+const int SIM_DEFEAT = 1;
+const int SIM_TIMEOUT = 2;
 
 
+/// purpose: scripted pilot for headless games; sweeps across the screen and taps fire so every game makes progress.
+/// parameters: seed shifts the sweep phase so consecutive games do not play identically.
+/// return: next yields the input for one tick.
+class AutoPilot {
+private:
+    float phase;
 
-        timerDigits[0].setTexture(timerNumeralTextures[minute1]);
-        timerDigits[0].setScale(1.5f, 1.5f);
-        timerDigits[0].setPosition(centerX - 2.5f * digitSpacing, startY);
+public:
+    AutoPilot(unsigned int seed = 0) : phase((float)(seed % 628) / 100.0f) {}
 
+    PlayerInput next(const Level1& level, long tick) const {
+        PlayerInput input;
 
-        timerDigits[1].setTexture(timerNumeralTextures[minute2]);
-        timerDigits[1].setScale(1.5f, 1.5f);
-        timerDigits[1].setPosition(centerX - 1.5f * digitSpacing, startY);
+        float targetX = 960.0f + 800.0f * std::sin(phase + tick * 0.01f);
+        float x = level.getPlayerPosition().x;
+        if (x < targetX - 10.0f) input.right = true;
+        else if (x > targetX + 10.0f) input.left = true;
 
+        input.fire = (tick % 8) < 4;
+        return input;
+    }
+};
 
-        timerDigits[2].setTexture(timerNumeralTextures[second1]);
-        timerDigits[2].setScale(1.5f, 1.5f);
-        timerDigits[2].setPosition(centerX + 0.5f * digitSpacing, startY);
 
+/// purpose: runs complete games (level1 -> level2 -> boss level) without a window, as fast as the cpu allows.
+/// parameters: levels are configured like Game's; each game reseeds its levels from the base seed for reproducibility.
+/// return: run prints outcome counts and throughput in ticks/sec.
+class HeadlessSimulator {
+private:
+    Level1 levels[3];
 
-        timerDigits[3].setTexture(timerNumeralTextures[second2]);
-        timerDigits[3].setScale(1.5f, 1.5f);
-        timerDigits[3].setPosition(centerX + 1.5f * digitSpacing, startY);
-    }
+public:
+    HeadlessSimulator() {
+        levels[0].loadAssets();
+
+        levels[1].loadAssets("bg1.jpg");
+        levels[1].configureDifficulty(0.8f, 0.8f, 540.0f, "Blue", 3);
+
+        levels[2].loadAssets("bg5.jpg", "Green");
+        levels[2].configureDifficulty(0.6f, 0.8f, 600.0f, "Green", 3);
+    }
+
+    int runGame(unsigned int seed, long long& ticks, int& finalScore) {
+        AutoPilot pilot(seed);
+
+        int totalScore = 0;
+        float totalTime = 0.0f;
+        finalScore = 0;
+
+        for (int l = 0; l < 3; l++) {
+            Level1& level = levels[l];
+            level.stopTimer();
+            level.reset();
+            level.setSeed(seed + (unsigned int)l * 0x9E3779B9u);
+            level.setScoreOffset(totalScore);
+            if (l == 0) level.startTimer();
+            else level.continueTimer(totalTime);
+
+            bool levelDone = false;
+            for (long tick = 0; tick < MAX_SIMULATED_LEVEL_TICKS && !levelDone; tick++) {
+                level.update(SIMULATION_DT, pilot.next(level, tick));
+                PROFILER_END_FRAME();
+                ticks++;
+
+                bool won = (l == 2) ? level.isBossDefeated() : level.getScore() >= level.calculateTargetScore();
+                if (level.isPlayerDestroyed()) {
+                    finalScore = totalScore + level.getScore();
+                    return SIM_DEFEAT;
+                }
+                levelDone = won;
+            }
 
-    bool isPlayerDestroyed() const {
-        return isDestroyed;
+            totalScore += level.getScore();
+            totalTime = level.getCurrentTime();
+            finalScore = totalScore;
+            if (!levelDone) return SIM_TIMEOUT;
+        }
+        return SIM_VICTORY;
     }
 
-    int getScore() const {
-        return score;
-    }
+    void run(int games, unsigned int seed) {
+        int outcomes[3] = { 0, 0, 0 };
+        long long ticks = 0;
+        long long scoreSum = 0;
 
-    void drawBullets(sf::RenderWindow& window) {
-        for (int i = 0; i < 20; i++) {
-            bulletPool->get(i)->draw(window);
+        sf::Clock wallClock;
+        for (int g = 0; g < games; g++) {
+            int score = 0;
+            outcomes[runGame(seed + (unsigned int)g, ticks, score)]++;
+            scoreSum += score;
         }
-    }
+        double seconds = wallClock.getElapsedTime().asSeconds();
 
-    void drawMeteors(sf::RenderWindow& window) {
-        for (int i = 0; i < 20; i++) {
-            meteors[i].draw(window);
+        cout << "Simulated " << games << " games: " << outcomes[SIM_VICTORY] << " victories, "
+            << outcomes[SIM_DEFEAT] << " defeats, " << outcomes[SIM_TIMEOUT] << " timeouts" << endl;
+        if (games > 0) {
+            cout << "Average score: " << (double)scoreSum / games << endl;
         }
-    }
-
-    void drawPowerUps(sf::RenderWindow& window) {
-        for (int i = 0; i < 10; i++) {
-            powerups[i].draw(window);
+        cout << "Ticks: " << ticks << " in " << seconds << " s";
+        if (seconds > 0.0) {
+            cout << " (" << (long long)(ticks / seconds) << " ticks/sec)";
         }
+        cout << endl;
+        PROFILER_EXPORT_CSV("profile_simulation.csv");
     }
 
-    void drawEnemies(sf::RenderWindow& window) {
-
-        if (bossEnemy != nullptr && bossEnemy->isActive()) {
-            bossEnemy->draw(window);
+    /// purpose: play a recorded session back as fast as possible and check it against the recorded checksums.
+    /// return: false if the replay cannot be loaded or playback diverged.
+    bool playReplay(const string& path) {
+        Level1& level = levels[0];
+        if (!level.startReplay(path)) {
+            cout << "Cannot load replay " << path << endl;
+            return false;
         }
 
+        sf::Clock wallClock;
+        PlayerInput ignored;
+        while (!level.isReplayFinished()) {
+            level.update(SIMULATION_DT, ignored);
+            PROFILER_END_FRAME();
+        }
+        double seconds = wallClock.getElapsedTime().asSeconds();
 
-        for (int i = 0; i < 10; i++) {
-            if (enemies[i] != 0) {
-                enemies[i]->draw(window);
-            }
+        long ticks = level.getReplayLength();
+        cout << "Replayed " << ticks << " ticks in " << seconds << " s";
+        if (seconds > 0.0) {
+            cout << " (" << (long long)(ticks / seconds) << " ticks/sec)";
         }
-    }
+        cout << ", score " << level.getScore() << endl;
 
-    void drawEnemyBullets(sf::RenderWindow& window) {
-        for (int i = 0; i < 50; i++) {
-            enemyBullets[i].draw(window);
+        long divergedAt = level.getReplayDivergence();
+        if (divergedAt >= 0) {
+            cout << "Replay diverged at tick " << divergedAt << endl;
+        }
+        else {
+            cout << "Replay matches the recording" << endl;
         }
+        level.stopReplay();
+        return divergedAt < 0;
     }
+};
 
-    void draw(sf::RenderWindow& window) {
-        window.draw(bgSprite);
-        drawMeteors(window);
-        drawPowerUps(window);
-        drawEnemies(window);
-        drawEnemyBullets(window);
 
 
-        if (hasShield) {
-            shieldSprite.setPosition(player.getPosition());
-            shieldSprite.setRotation(player.getRotation());
-            window.draw(shieldSprite);
-        }
 
-        window.draw(player);
-        drawBullets(window);
+/// purpose: one point of a difficulty sweep: the arguments of Level1::configureDifficulty.
+struct DifficultyConfig {
+    float meteorInterval;
+    float enemyInterval;
+    float playerSpeed;
+    string enemyColor;
+    int waves;
+};
 
 
-        window.draw(lifeIcon);
-        window.draw(xSprite);
-        window.draw(lifeCountSprite);
+struct BatchGameResult {
+    int outcome;
+    int score;
+    float time;
+    long ticks;
+    int kills;
+};
 
 
-        int displayScore = score + scoreOffset;
-        string scoreStr = std::to_string(displayScore);
-        for (int i = 0; i < (int)scoreStr.length() && i < 6; i++) {
-            window.draw(scoreDigits[i]);
-        }
+/// purpose: one worker's share of the job list; the owner takes jobs from the front, idle workers split off the back half.
+struct BatchWorkRange {
+    mutex lock;
+    int begin;
+    int end;
+};
 
 
-        if (showPowerUpFlash) {
-            window.draw(powerUpFlash);
-        }
+const int MAX_SWEEP_CONFIGS = 128;
 
 
-        float barWidth = 200.0f;
-        float barHeight = 15.0f;
-        float barX = (float)screenW / 2.0f - barWidth / 2.0f;
-        float barY = 60.0f;
+/// purpose: plays many single-level games per difficulty config on all cores and aggregates the outcomes.
+/// parameters: every config is played with the same seeds (base seed + game number), so configs are compared on
+///             identical meteor and wave sequences; each worker thread owns its own Level1.
+/// return: writeCsv emits one row per config with completion rate and score / time / kill distributions.
+class BatchSimulator {
+private:
+    DifficultyConfig configs[MAX_SWEEP_CONFIGS];
+    int configCount;
+    int gamesPerConfig;
+    unsigned int baseSeed;
+
+    BatchGameResult* results;
+    BatchWorkRange* ranges;
+    int workerCount;
+
+    bool takeJob(int worker, int& job) {
+        BatchWorkRange& own = ranges[worker];
+        {
+            lock_guard<mutex> guard(own.lock);
+            if (own.begin < own.end) {
+                job = own.begin++;
+                return true;
+            }
+        }
+
+        for (int k = 1; k < workerCount; k++) {
+            BatchWorkRange& victim = ranges[(worker + k) % workerCount];
+            int stolenBegin;
+            int stolenEnd;
+            {
+                lock_guard<mutex> guard(victim.lock);
+                int remaining = victim.end - victim.begin;
+                if (remaining <= 0) continue;
 
-        if (hasDoubleFire && doubleFireTimer > 0.0f) {
+                stolenEnd = victim.end;
+                stolenBegin = victim.end - (remaining + 1) / 2;
+                victim.end = stolenBegin;
+            }
 
-            sf::RectangleShape barBg(sf::Vector2f(barWidth, barHeight));
-            barBg.setPosition(barX, barY);
-            barBg.setFillColor(sf::Color(50, 50, 50, 200));
-            barBg.setOutlineThickness(2);
-            barBg.setOutlineColor(sf::Color::White);
-            window.draw(barBg);
+            job = stolenBegin;
+            if (stolenBegin + 1 < stolenEnd) {
+                lock_guard<mutex> guard(own.lock);
+                own.begin = stolenBegin + 1;
+                own.end = stolenEnd;
+            }
+            return true;
+        }
+        return false;
+    }
 
+    void workerLoop(int worker) {
+        Level1 level;
+        level.loadAssets();
 
-            float fillWidth = (doubleFireTimer / 10.0f) * barWidth;
-            sf::RectangleShape barFill(sf::Vector2f(fillWidth, barHeight));
-            barFill.setPosition(barX, barY);
+        int job;
+        while (takeJob(worker, job)) {
+            unsigned int seed = baseSeed + (unsigned int)(job % gamesPerConfig);
+            results[job] = playGame(level, configs[job / gamesPerConfig], seed);
+        }
+    }
 
+    static BatchGameResult playGame(Level1& level, const DifficultyConfig& config, unsigned int seed) {
+        level.configureDifficulty(config.meteorInterval, config.enemyInterval, config.playerSpeed, config.enemyColor, config.waves);
+        level.stopTimer();
+        level.reset();
+        level.setSeed(seed);
+        level.setScoreOffset(0);
+        level.startTimer();
+        AutoPilot pilot(seed);
 
-            if (doubleFireTimer < 5.0f) {
-                barFill.setFillColor(sf::Color(255, 50, 50));
+        BatchGameResult result;
+        result.outcome = SIM_TIMEOUT;
+        long tick = 0;
+        while (tick < MAX_SIMULATED_LEVEL_TICKS) {
+            level.update(SIMULATION_DT, pilot.next(level, tick));
+            tick++;
+            if (level.isPlayerDestroyed()) {
+                result.outcome = SIM_DEFEAT;
+                break;
             }
-            else {
-                barFill.setFillColor(sf::Color(255, 100, 50));
+            if (level.isCleared()) {
+                result.outcome = SIM_VICTORY;
+                break;
             }
-            window.draw(barFill);
+        }
+
+        result.score = level.getScore();
+        result.time = level.getCurrentTime();
+        result.ticks = tick;
+        result.kills = level.getEnemiesDestroyed();
+        return result;
+    }
 
-            barY += 20.0f;
-        }
+    /// return: nearest-rank percentile p (0..1) of an ascending array.
+    static float percentile(const float* sorted, int n, float p) {
+        int rank = (int)(p * (n - 1) + 0.5f);
+        return sorted[rank < n ? rank : n - 1];
+    }
 
-        if (hasShield && shieldTimer > 0.0f) {
+public:
+    BatchSimulator() : configCount(0), gamesPerConfig(0), baseSeed(1), results(nullptr), ranges(nullptr), workerCount(0) {}
 
-            sf::RectangleShape barBg(sf::Vector2f(barWidth, barHeight));
-            barBg.setPosition(barX, barY);
-            barBg.setFillColor(sf::Color(50, 50, 50, 200));
-            barBg.setOutlineThickness(2);
-            barBg.setOutlineColor(sf::Color::White);
-            window.draw(barBg);
+    ~BatchSimulator() {
+        delete[] results;
+        delete[] ranges;
+    }
 
+    bool addConfig(float meteorInterval, float enemyInterval, float playerSpeed, const string& enemyColor, int waves) {
+        if (configCount == MAX_SWEEP_CONFIGS) return false;
 
-            float fillWidth = (shieldTimer / 10.0f) * barWidth;
-            sf::RectangleShape barFill(sf::Vector2f(fillWidth, barHeight));
-            barFill.setPosition(barX, barY);
+        DifficultyConfig& config = configs[configCount++];
+        config.meteorInterval = meteorInterval;
+        config.enemyInterval = enemyInterval;
+        config.playerSpeed = playerSpeed;
+        config.enemyColor = enemyColor;
+        config.waves = waves;
+        return true;
+    }
 
+    /// purpose: 81 configs: the three story levels crossed with looser and tighter spawn rates and ship speeds.
+    void addDefaultSweep() {
+        const float meteorIntervals[] = { 1.5f, 1.0f, 0.6f };
+        const float enemyIntervals[] = { 1.5f, 1.0f, 0.8f };
+        const float playerSpeeds[] = { 450.0f, 540.0f, 600.0f };
+        const string colors[] = { "Red", "Blue", "Green" };
+        const int waves[] = { 2, 3, 3 };
 
-            if (shieldTimer < 5.0f) {
-                barFill.setFillColor(sf::Color(255, 50, 50));
-            }
-            else {
-                barFill.setFillColor(sf::Color(50, 255, 100));
+        for (int l = 0; l < 3; l++) {
+            for (float meteorInterval : meteorIntervals) {
+                for (float enemyInterval : enemyIntervals) {
+                    for (float playerSpeed : playerSpeeds) {
+                        addConfig(meteorInterval, enemyInterval, playerSpeed, colors[l], waves[l]);
+                    }
+                }
             }
-            window.draw(barFill);
         }
+    }
 
+    int getConfigCount() const { return configCount; }
 
-        if (timerRunning || isDestroyed) {
-
-            for (int i = 0; i < 4; i++) {
-                window.draw(timerDigits[i]);
-            }
+    /// parameters: threads <= 0 uses every hardware thread.
+    void run(int games, unsigned int seed, int threads = 0) {
+        if (games < 1 || configCount == 0) return;
+        if (threads <= 0) threads = (int)std::thread::hardware_concurrency();
+        if (threads <= 0) threads = 1;
+        gamesPerConfig = games;
+        baseSeed = seed;
 
+        int jobCount = configCount * gamesPerConfig;
+        delete[] results;
+        delete[] ranges;
+        results = new BatchGameResult[jobCount];
+        ranges = new BatchWorkRange[threads];
+        workerCount = threads;
+        for (int w = 0; w < threads; w++) {
+            ranges[w].begin = (int)((long long)jobCount * w / threads);
+            ranges[w].end = (int)((long long)jobCount * (w + 1) / threads);
+        }
 
-            float centerX = (float)screenW * 0.5f;
-            float colonY = 30.0f;
+        sf::Clock wallClock;
+        std::thread* workers = new std::thread[threads];
+        for (int w = 0; w < threads; w++) {
+            workers[w] = std::thread(&BatchSimulator::workerLoop, this, w);
+        }
+        for (int w = 0; w < threads; w++) {
+            workers[w].join();
+        }
+        delete[] workers;
+        double seconds = wallClock.getElapsedTime().asSeconds();
 
+        long long ticks = 0;
+        for (int j = 0; j < jobCount; j++) {
+            ticks += results[j].ticks;
+        }
+        cout << "Simulated " << jobCount << " games (" << configCount << " configs x " << gamesPerConfig << ") on "
+            << threads << " threads in " << seconds << " s";
+        if (seconds > 0.0) {
+            cout << " (" << (long long)(ticks / seconds) << " ticks/sec)";
+        }
+        cout << endl;
+    }
 
-            sf::CircleShape colonDot1(4.0f);
-            colonDot1.setFillColor(sf::Color::White);
-            colonDot1.setPosition(centerX - 15.0f, colonY - 5.0f);
-            window.draw(colonDot1);
+    bool writeCsv(const string& path) const {
+        if (results == nullptr) return false;
 
-            sf::CircleShape colonDot2(4.0f);
-            colonDot2.setFillColor(sf::Color::White);
-            colonDot2.setPosition(centerX - 15.0f, colonY + 15.0f);
-            window.draw(colonDot2);
-        }
+        ofstream out(path);
+        if (!out) return false;
 
+        out << "meteor_interval,enemy_interval,player_speed,enemy_color,waves,games,victories,defeats,timeouts,"
+            << "completion_rate,score_mean,score_p10,score_p50,score_p90,time_mean,time_p10,time_p50,time_p90,kills_mean\n";
 
-        if (showingWaveAnnouncement) {
-            waveAnnouncement.draw(window);
-        }
+        float* scores = new float[gamesPerConfig];
+        float* times = new float[gamesPerConfig];
+        for (int c = 0; c < configCount; c++) {
+            const DifficultyConfig& config = configs[c];
+            int outcomes[3] = { 0, 0, 0 };
+            double scoreSum = 0.0, timeSum = 0.0, killSum = 0.0;
 
+            for (int g = 0; g < gamesPerConfig; g++) {
+                const BatchGameResult& r = results[c * gamesPerConfig + g];
+                outcomes[r.outcome]++;
+                scores[g] = (float)r.score;
+                times[g] = r.time;
+                scoreSum += r.score;
+                timeSum += r.time;
+                killSum += r.kills;
+            }
+            sort(scores, scores + gamesPerConfig);
+            sort(times, times + gamesPerConfig);
 
+            double n = gamesPerConfig;
+            out << config.meteorInterval << "," << config.enemyInterval << "," << config.playerSpeed << ","
+                << config.enemyColor << "," << config.waves << "," << gamesPerConfig << ","
+                << outcomes[SIM_VICTORY] << "," << outcomes[SIM_DEFEAT] << "," << outcomes[SIM_TIMEOUT] << ","
+                << outcomes[SIM_VICTORY] / n << "," << scoreSum / n << ","
+                << percentile(scores, gamesPerConfig, 0.1f) << "," << percentile(scores, gamesPerConfig, 0.5f) << ","
+                << percentile(scores, gamesPerConfig, 0.9f) << "," << timeSum / n << ","
+                << percentile(times, gamesPerConfig, 0.1f) << "," << percentile(times, gamesPerConfig, 0.5f) << ","
+                << percentile(times, gamesPerConfig, 0.9f) << "," << killSum / n << "\n";
+        }
+        delete[] scores;
+        delete[] times;
+        return (bool)out;
     }
 };
 
@@ -3669,7 +6521,7 @@ public:
     }
 
     bool loadFont(const string& fontPath) {
-        if (font.loadFromFile(fontPath)) {
+        if (loadFontAsset(font, fontPath)) {
             fontLoaded = true;
             if (windowWidth > 0 && windowHeight > 0) {
                 initializeOptions();
@@ -3677,7 +6529,7 @@ public:
             return true;
         }
 
-        if (font.loadFromFile("arial.ttf")) {
+        if (loadFontAsset(font, "arial.ttf")) {
             fontLoaded = true;
             if (windowWidth > 0 && windowHeight > 0) {
                 initializeOptions();
@@ -3752,7 +6604,7 @@ private:
     sf::Text messageText;
     sf::Sprite timeDigits[4];
     float finalTime;
-    sf::Texture numeralTextures[10];
+    TextureHandle numeralTextures[10];
     sf::Sprite scoreSprites[6];
     int currentScore;
 
@@ -3865,12 +6717,12 @@ public:
     }
 
     bool loadFont(const string& fontPath) {
-        if (font.loadFromFile(fontPath)) {
+        if (loadFontAsset(font, fontPath)) {
             fontLoaded = true;
             if (windowWidth > 0 && windowHeight > 0) initializeOptions();
             return true;
         }
-        if (font.loadFromFile("arial.ttf")) {
+        if (loadFontAsset(font, "arial.ttf")) {
             fontLoaded = true;
             if (windowWidth > 0 && windowHeight > 0) initializeOptions();
             return true;
@@ -3929,7 +6781,7 @@ public:
         for (int i = 0; i < (int)scoreStr.length(); i++) {
             int digit = scoreStr[i] - '0';
             if (i < 6) {
-                scoreSprites[i].setTexture(numeralTextures[digit]);
+                numeralTextures[digit].applyTo(scoreSprites[i]);
                 scoreSprites[i].setScale(1.2f, 1.2f);
                 scoreSprites[i].setPosition(startX + i * 40.0f, startY);
             }
@@ -3956,19 +6808,19 @@ public:
         float digitSpacing = 40.0f;
 
 
-        timeDigits[0].setTexture(numeralTextures[minute1]);
+        numeralTextures[minute1].applyTo(timeDigits[0]);
         timeDigits[0].setScale(1.2f, 1.2f);
         timeDigits[0].setPosition(centerX - 2.0f * digitSpacing, startY);
 
-        timeDigits[1].setTexture(numeralTextures[minute2]);
+        numeralTextures[minute2].applyTo(timeDigits[1]);
         timeDigits[1].setScale(1.2f, 1.2f);
         timeDigits[1].setPosition(centerX - 1.0f * digitSpacing, startY);
 
-        timeDigits[2].setTexture(numeralTextures[second1]);
+        numeralTextures[second1].applyTo(timeDigits[2]);
         timeDigits[2].setScale(1.2f, 1.2f);
         timeDigits[2].setPosition(centerX + 0.5f * digitSpacing, startY);
 
-        timeDigits[3].setTexture(numeralTextures[second2]);
+        numeralTextures[second2].applyTo(timeDigits[3]);
         timeDigits[3].setScale(1.2f, 1.2f);
         timeDigits[3].setPosition(centerX + 1.5f * digitSpacing, startY);
     }
@@ -4037,6 +6889,366 @@ public:
 
 
 
+const int MAX_HIGH_SCORES = 50;
+const int HIGH_SCORE_NAME_LENGTH = 16;
+const unsigned int SCORE_JOURNAL_MAGIC = 0x53485747;
+const unsigned int SCORE_JOURNAL_VERSION = 1;
+/// the journal is rewritten down to the top MAX_HIGH_SCORES once it holds this many records.
+const int SCORE_JOURNAL_COMPACT_AT = 256;
+const char* const SCORE_JOURNAL_PATH = "highscores.dat";
+const char* const LEGACY_SCORES_PATH = "highscores.txt";
+
+
+/// purpose: one fixed-size journal entry; the checksum rejects records torn by a crash mid-append.
+struct ScoreRecord {
+    char name[HIGH_SCORE_NAME_LENGTH];
+    int score;
+    int time;
+    unsigned int checksum;
+
+    unsigned int computeChecksum() const {
+        unsigned int hash = hashBytes(HASH_SEED, name, sizeof(name));
+        hash = hashBytes(hash, &score, sizeof(score));
+        return hashBytes(hash, &time, sizeof(time));
+    }
+
+    /// return: true when a record should rank above other (higher score, then faster time).
+    bool ranksAbove(const ScoreRecord& other) const {
+        return score > other.score || (score == other.score && time < other.time);
+    }
+};
+
+
+/// purpose: append-only binary high-score journal. Writes are queued to a background thread, which appends one
+///          record per score and, once the journal grows past SCORE_JOURNAL_COMPACT_AT, writes the top scores to a
+///          temp file and renames it over the journal. A crash leaves either the old or the new file, never half of one.
+/// parameters: path defaults to highscores.dat; an old highscores.txt next to it is imported on first use.
+/// return: readTable returns the ranked top entries; damaged or torn records are skipped.
+class ScoreJournal {
+private:
+    string path;
+    ScoreRecord* pending;
+    int pendingCount;
+    int pendingCapacity;
+    bool busy;
+    bool stopping;
+    int recordCount;
+    mutex queueLock;
+    condition_variable queueChanged;
+    std::thread writer;
+
+    /// purpose: write a file and force it to disk before returning, so a following rename is durable.
+    static bool writeDurably(const string& filePath, const char* mode, const void* data, size_t size) {
+        FILE* file = fopen(filePath.c_str(), mode);
+        if (file == nullptr) return false;
+
+        bool ok = fwrite(data, 1, size, file) == size && fflush(file) == 0;
+#ifdef _WIN32
+        ok = ok && _commit(_fileno(file)) == 0;
+#else
+        ok = ok && fsync(fileno(file)) == 0;
+#endif
+        return fclose(file) == 0 && ok;
+    }
+
+    /// purpose: replace the journal with a compacted one holding only the given records.
+    static bool writeTable(const string& filePath, const ScoreRecord* records, int count) {
+        size_t size = 2 * sizeof(unsigned int) + count * sizeof(ScoreRecord);
+        char* buffer = new char[size];
+        unsigned int header[2] = { SCORE_JOURNAL_MAGIC, SCORE_JOURNAL_VERSION };
+        memcpy(buffer, header, sizeof(header));
+        memcpy(buffer + sizeof(header), records, count * sizeof(ScoreRecord));
+
+        string tempPath = filePath + ".tmp";
+        bool ok = writeDurably(tempPath, "wb", buffer, size);
+        delete[] buffer;
+        if (!ok) return false;
+
+        std::error_code error;
+        std::filesystem::rename(tempPath, filePath, error);
+        return !error;
+    }
+
+    /// purpose: one-time import of the old "name score time" text table; lines that do not parse are skipped.
+    static int readLegacyTable(const string& filePath, ScoreRecord* out, int maxRecords) {
+        MappedFile file;
+        if (!file.open(filePath)) return 0;
+
+        const char* cursor = file.getData();
+        const char* fileEnd = cursor + file.getSize();
+        int count = 0;
+        while (count < maxRecords && cursor < fileEnd) {
+            const char* lineEnd = (const char*)memchr(cursor, '\n', fileEnd - cursor);
+            if (lineEnd == nullptr) lineEnd = fileEnd;
+            const char* line = cursor;
+            cursor = lineEnd + 1;
+
+            const char* end = lineEnd;
+            if (end > line && end[-1] == '\r') end--;
+            const char* lastSpace = end;
+            while (lastSpace > line && lastSpace[-1] != ' ') lastSpace--;
+            if (lastSpace <= line + 1) continue;
+            const char* secondLastSpace = lastSpace - 1;
+            while (secondLastSpace > line && secondLastSpace[-1] != ' ') secondLastSpace--;
+            if (secondLastSpace <= line + 1) continue;
+
+            int score = 0;
+            int time = 0;
+            from_chars_result parsed = from_chars(secondLastSpace, lastSpace - 1, score);
+            if (parsed.ec != errc() || parsed.ptr != lastSpace - 1) continue;
+            parsed = from_chars(lastSpace, end, time);
+            if (parsed.ec != errc() || parsed.ptr != end) continue;
+
+            out[count++] = makeRecord(string(line, secondLastSpace - 1), score, time);
+        }
+        return count;
+    }
+
+    void migrateLegacyTable() {
+        if (std::filesystem::exists(path) || !std::filesystem::exists(LEGACY_SCORES_PATH)) return;
+
+        ScoreRecord* records = new ScoreRecord[MAX_HIGH_SCORES];
+        int count = readLegacyTable(LEGACY_SCORES_PATH, records, MAX_HIGH_SCORES);
+        if (writeTable(path, records, count)) {
+            gameLog() << "Imported " << count << " scores from " << LEGACY_SCORES_PATH << endl;
+        }
+        delete[] records;
+    }
+
+    void append(const ScoreRecord& record) {
+        if (recordCount == 0 && !std::filesystem::exists(path)) {
+            writeTable(path, &record, 1);
+            recordCount = 1;
+            return;
+        }
+
+        if (!writeDurably(path, "ab", &record, sizeof(record))) {
+            cout << "ERROR: could not append to " << path << endl;
+            return;
+        }
+        recordCount++;
+
+        if (recordCount >= SCORE_JOURNAL_COMPACT_AT) {
+            ScoreRecord* top = new ScoreRecord[MAX_HIGH_SCORES];
+            int kept = readTable(path, top, MAX_HIGH_SCORES);
+            if (writeTable(path, top, kept)) {
+                recordCount = kept;
+            }
+            delete[] top;
+        }
+    }
+
+    /// purpose: make the journal safe to append to before the first write. A file whose header is missing or
+    ///          unknown is moved aside to <path>.bad so scores start a fresh journal instead of vanishing into it,
+    ///          and a record torn by a crash mid-append is cut off so later records stay aligned.
+    void repairJournal() {
+        std::error_code error;
+        uintmax_t size = std::filesystem::file_size(path, error);
+        if (error) return;
+
+        unsigned int header[2] = { 0, 0 };
+        FILE* file = fopen(path.c_str(), "rb");
+        bool readable = file != nullptr && fread(header, 1, sizeof(header), file) == sizeof(header);
+        if (file != nullptr) fclose(file);
+
+        if (!readable || header[0] != SCORE_JOURNAL_MAGIC || header[1] != SCORE_JOURNAL_VERSION) {
+            string badPath = path + ".bad";
+            std::filesystem::rename(path, badPath, error);
+            if (error) {
+                std::filesystem::remove(path, error);
+            }
+            cout << "WARNING: " << path << " is not a score journal; moved it to " << badPath << endl;
+            return;
+        }
+
+        recordCount = (int)((size - sizeof(header)) / sizeof(ScoreRecord));
+        uintmax_t intactSize = sizeof(header) + recordCount * sizeof(ScoreRecord);
+        if (size != intactSize) {
+            std::filesystem::resize_file(path, intactSize, error);
+            gameLog() << "Dropped a torn score record from " << path << endl;
+        }
+    }
+
+    void writerLoop() {
+        migrateLegacyTable();
+        repairJournal();
+
+        unique_lock<mutex> guard(queueLock);
+        busy = false;
+        queueChanged.notify_all();
+        while (true) {
+            queueChanged.wait(guard, [this]() { return pendingCount > 0 || stopping; });
+            if (pendingCount == 0 && stopping) break;
+
+            ScoreRecord record = pending[0];
+            for (int i = 1; i < pendingCount; i++) {
+                pending[i - 1] = pending[i];
+            }
+            pendingCount--;
+            busy = true;
+
+            guard.unlock();
+            append(record);
+            guard.lock();
+
+            busy = false;
+            queueChanged.notify_all();
+        }
+    }
+
+public:
+    ScoreJournal(const string& journalPath = SCORE_JOURNAL_PATH)
+        : path(journalPath), pendingCount(0), pendingCapacity(16), busy(true), stopping(false), recordCount(0) {
+        pending = new ScoreRecord[pendingCapacity];
+        writer = std::thread(&ScoreJournal::writerLoop, this);
+    }
+
+    /// purpose: writes still queued are finished before the thread stops.
+    ~ScoreJournal() {
+        {
+            lock_guard<mutex> guard(queueLock);
+            stopping = true;
+        }
+        queueChanged.notify_all();
+        writer.join();
+        delete[] pending;
+    }
+
+    static ScoreJournal& shared() {
+        static ScoreJournal journal;
+        return journal;
+    }
+
+    static ScoreRecord makeRecord(const string& playerName, int score, int time) {
+        ScoreRecord record;
+        memset(&record, 0, sizeof(record));
+        strncpy(record.name, playerName.c_str(), HIGH_SCORE_NAME_LENGTH - 1);
+        record.score = score;
+        record.time = time;
+        record.checksum = record.computeChecksum();
+        return record;
+    }
+
+    /// purpose: queue a score and return immediately; the disk is only touched by the writer thread.
+    void submit(const string& playerName, int score, int time) {
+        {
+            lock_guard<mutex> guard(queueLock);
+            if (pendingCount == pendingCapacity) {
+                ScoreRecord* grown = new ScoreRecord[pendingCapacity * 2];
+                memcpy(grown, pending, pendingCount * sizeof(ScoreRecord));
+                delete[] pending;
+                pending = grown;
+                pendingCapacity *= 2;
+            }
+            pending[pendingCount++] = makeRecord(playerName, score, time);
+        }
+        queueChanged.notify_all();
+    }
+
+    /// purpose: block until every queued score (and the startup import) is on disk.
+    void flush() {
+        unique_lock<mutex> guard(queueLock);
+        queueChanged.wait(guard, [this]() { return pendingCount == 0 && !busy; });
+    }
+
+    const string& getPath() const { return path; }
+
+    /// purpose: read a journal and rank it; records with a bad checksum or a torn tail are skipped.
+    /// return: number of records written to out, best first, at most maxRecords.
+    static int readTable(const string& filePath, ScoreRecord* out, int maxRecords) {
+        MappedFile file;
+        if (!file.open(filePath)) return 0;
+        return rankJournal(file.getData(), file.getSize(), out, maxRecords);
+    }
+
+    /// purpose: rank a journal image already in memory; see readTable.
+    static int rankJournal(const char* data, size_t size, ScoreRecord* out, int maxRecords) {
+        unsigned int header[2] = { 0, 0 };
+        if (size < sizeof(header)) return 0;
+        memcpy(header, data, sizeof(header));
+        if (header[0] != SCORE_JOURNAL_MAGIC || header[1] != SCORE_JOURNAL_VERSION) return 0;
+
+        int count = 0;
+        ScoreRecord record;
+        for (size_t offset = sizeof(header); offset + sizeof(record) <= size; offset += sizeof(record)) {
+            memcpy(&record, data + offset, sizeof(record));
+            if (record.checksum != record.computeChecksum()) continue;
+            record.name[HIGH_SCORE_NAME_LENGTH - 1] = '\0';
+
+            int position = count;
+            while (position > 0 && record.ranksAbove(out[position - 1])) {
+                position--;
+            }
+            if (position >= maxRecords) continue;
+
+            int last = (count < maxRecords) ? count : maxRecords - 1;
+            for (int i = last; i > position; i--) {
+                out[i] = out[i - 1];
+            }
+            out[position] = record;
+            if (count < maxRecords) count++;
+        }
+        return count;
+    }
+};
+
+
+
+
+/// purpose: the ranked high-score table kept in memory. refresh() checks the journal's size and modification time
+///          and only maps and re-ranks it when either changed, so reopening the high-score screen costs two stat calls.
+/// return: getVersion() changes whenever the entries do, for views that cache what they drew.
+class Leaderboard {
+private:
+    string path;
+    ScoreRecord entries[MAX_HIGH_SCORES];
+    int count;
+    unsigned int version;
+    bool loaded;
+    uintmax_t loadedSize;
+    std::filesystem::file_time_type loadedTime;
+
+public:
+    Leaderboard(const string& journalPath = SCORE_JOURNAL_PATH)
+        : path(journalPath), count(0), version(0), loaded(false), loadedSize(0) {}
+
+    static Leaderboard& shared() {
+        static Leaderboard leaderboard;
+        return leaderboard;
+    }
+
+    /// return: true when the table was reloaded.
+    bool refresh() {
+        std::error_code error;
+        uintmax_t size = std::filesystem::file_size(path, error);
+        std::filesystem::file_time_type time = error ? std::filesystem::file_time_type() : std::filesystem::last_write_time(path, error);
+        if (error) {
+            if (loaded && count == 0) return false;
+            size = 0;
+            time = std::filesystem::file_time_type();
+        }
+        else if (loaded && size == loadedSize && time == loadedTime) {
+            return false;
+        }
+
+        MappedFile file;
+        count = (size > 0 && file.open(path)) ? ScoreJournal::rankJournal(file.getData(), file.getSize(), entries, MAX_HIGH_SCORES) : 0;
+        loaded = true;
+        loadedSize = size;
+        loadedTime = time;
+        version++;
+        return true;
+    }
+
+    const ScoreRecord& getEntry(int index) const { return entries[index]; }
+    int getCount() const { return count; }
+    unsigned int getVersion() const { return version; }
+    const string& getPath() const { return path; }
+};
+
+
+
+
 class HighScoreScreen {
 private:
     sf::Font font;
@@ -4051,28 +7263,93 @@ private:
     int times[50];
     int count;
     int scrollOffset;
+    unsigned int shownVersion;
 
 
-    sf::Texture numeralTextures[10];
-    sf::Texture dotTexture;
+    TextureHandle numeralTextures[10];
     sf::Sprite rankSprites[10][3];
     sf::Sprite scoreSprites[10][6];
     sf::Sprite timeSprites[10][5];
+    int rankDigits[10];
+    int scoreDigits[10];
+    sf::Text dotText;
+    sf::CircleShape colonDot;
+
+    /// the table is drawn into tableTexture only when tableDirty is set, then shown as one sprite.
+    sf::RenderTexture tableTexture;
+    sf::Sprite tableSprite;
+    bool tableTextureReady;
+    bool tableDirty;
+
+    /// purpose: draws everything except the animated starfield; the target is tableTexture, or the window when
+    ///          no render texture could be created.
+    void drawTable(sf::RenderTarget& target) {
+        target.draw(titleText);
+        for (int i = 0; i < 4; i++) {
+            target.draw(headers[i]);
+        }
+
+        float timeStartX = 1300.0f;
+        float digitSpacing = 25.0f;
+        for (int i = 0; i < 10; i++) {
+            int dataIndex = scrollOffset + i;
+            float rowY = 270.0f + i * 65.0f;
+
+            if (dataIndex < count) {
+                for (int d = 0; d < rankDigits[i]; d++) {
+                    target.draw(rankSprites[i][d]);
+                }
+
+                dotText.setPosition(400.0f + rankDigits[i] * 25.0f, rowY);
+                target.draw(dotText);
+
+                target.draw(nameEntries[i]);
+
+                for (int j = 0; j < scoreDigits[i]; j++) {
+                    target.draw(scoreSprites[i][j]);
+                }
+
+                for (int j = 0; j < 4; j++) {
+                    target.draw(timeSprites[i][j]);
+                }
+
+                colonDot.setPosition(timeStartX + digitSpacing * 2.1f, rowY + 8.0f);
+                target.draw(colonDot);
+                colonDot.setPosition(timeStartX + digitSpacing * 2.1f, rowY + 18.0f);
+                target.draw(colonDot);
+            }
+            else if (i == 0 && count == 0) {
+                target.draw(nameEntries[i]);
+            }
+        }
+
+        target.draw(scrollText);
+    }
 
 public:
-    HighScoreScreen() : count(0), scrollOffset(0) {
+    HighScoreScreen() : count(0), scrollOffset(0), shownVersion(0), tableTextureReady(false), tableDirty(true) {
         for (int i = 0; i < 50; i++) {
             names[i] = "";
             scores[i] = 0;
             times[i] = 0;
         }
+        for (int i = 0; i < 10; i++) {
+            rankDigits[i] = 0;
+            scoreDigits[i] = 0;
+        }
+        colonDot.setRadius(2.5f);
+        colonDot.setFillColor(sf::Color::White);
     }
 
     bool loadFont(const string& fontPath) {
-        if (!font.loadFromFile(fontPath)) {
+        if (!loadFontAsset(font, fontPath)) {
             return false;
         }
 
+        dotText.setFont(font);
+        dotText.setString(".");
+        dotText.setCharacterSize(28);
+        dotText.setFillColor(sf::Color::White);
 
         for (int i = 0; i < 10; i++) {
             string filename = "numeral" + std::to_string(i) + ".png";
@@ -4084,40 +7361,21 @@ public:
         return true;
     }
 
-    void loadScores() {
-        count = 0;
+    /// purpose: copy the leaderboard into the screen; does nothing when neither it nor the journal changed.
+    void loadScores(Leaderboard& leaderboard = Leaderboard::shared()) {
+        if (!leaderboard.refresh() && leaderboard.getVersion() == shownVersion) return;
+
+        shownVersion = leaderboard.getVersion();
+        count = leaderboard.getCount();
         for (int i = 0; i < 50; i++) {
-            names[i] = "";
-            scores[i] = 0;
-            times[i] = 0;
+            names[i] = (i < count) ? leaderboard.getEntry(i).name : "";
+            scores[i] = (i < count) ? leaderboard.getEntry(i).score : 0;
+            times[i] = (i < count) ? leaderboard.getEntry(i).time : 0;
         }
-
-        ifstream fileIn("highscores.txt");
-        if (fileIn) {
-            string line;
-            while (count < 50 && getline(fileIn, line)) {
-
-
-                size_t lastSpacePos = line.rfind(' ');
-                if (lastSpacePos != string::npos) {
-
-                    size_t secondLastSpace = line.rfind(' ', lastSpacePos - 1);
-                    if (secondLastSpace != string::npos) {
-
-                        names[count] = line.substr(0, secondLastSpace);
-
-
-                        scores[count] = stoi(line.substr(secondLastSpace + 1, lastSpacePos - secondLastSpace - 1));
-
-
-                        times[count] = stoi(line.substr(lastSpacePos + 1));
-
-                        count++;
-                    }
-                }
-            }
-            fileIn.close();
+        if (scrollOffset > 0 && scrollOffset > count - 10) {
+            scrollOffset = (count > 10) ? count - 10 : 0;
         }
+        updateDisplay();
     }
 
     void initialize() {
@@ -4193,7 +7451,9 @@ public:
         }
     }
 
+    /// purpose: lay out the visible rows and mark the cached table for redrawing; called on scroll and data change.
     void updateDisplay() {
+        tableDirty = true;
 
         for (int i = 0; i < 10; i++) {
             int dataIndex = scrollOffset + i;
@@ -4203,11 +7463,12 @@ public:
 
                 int rankNumber = dataIndex + 1;
                 string rankStr = std::to_string(rankNumber);
+                rankDigits[i] = ((int)rankStr.length() < 2) ? (int)rankStr.length() : 2;
 
 
-                for (int d = 0; d < (int)rankStr.length() && d < 2; d++) {
+                for (int d = 0; d < rankDigits[i]; d++) {
                     int digit = rankStr[d] - '0';
-                    rankSprites[i][d].setTexture(numeralTextures[digit]);
+                    numeralTextures[digit].applyTo(rankSprites[i][d]);
                     rankSprites[i][d].setScale(0.8f, 0.8f);
                     rankSprites[i][d].setPosition(400.0f + d * 25.0f, rowY);
                 }
@@ -4223,17 +7484,18 @@ public:
                 if (scores[dataIndex] > 0) {
                     string scoreStr = std::to_string(scores[dataIndex]);
                     float startX = 1000.0f;
+                    scoreDigits[i] = ((int)scoreStr.length() < 6) ? (int)scoreStr.length() : 6;
 
                     for (int j = 0; j < (int)scoreStr.length() && j < 6; j++) {
                         int digit = scoreStr[j] - '0';
-                        scoreSprites[i][j].setTexture(numeralTextures[digit]);
+                        numeralTextures[digit].applyTo(scoreSprites[i][j]);
                         scoreSprites[i][j].setScale(0.9f, 0.9f);
                         scoreSprites[i][j].setPosition(startX + j * 30.0f, rowY);
                     }
                 }
                 else {
-
-                    scoreSprites[i][0].setTexture(numeralTextures[0]);
+                    scoreDigits[i] = 1;
+                    numeralTextures[0].applyTo(scoreSprites[i][0]);
                     scoreSprites[i][0].setScale(0.9f, 0.9f);
                     scoreSprites[i][0].setPosition(1000.0f, rowY);
                 }
@@ -4253,20 +7515,20 @@ public:
                 float digitSpacing = 25.0f;
 
 
-                timeSprites[i][0].setTexture(numeralTextures[minute1]);
+                numeralTextures[minute1].applyTo(timeSprites[i][0]);
                 timeSprites[i][0].setScale(0.7f, 0.7f);
                 timeSprites[i][0].setPosition(timeStartX, rowY);
 
-                timeSprites[i][1].setTexture(numeralTextures[minute2]);
+                numeralTextures[minute2].applyTo(timeSprites[i][1]);
                 timeSprites[i][1].setScale(0.7f, 0.7f);
                 timeSprites[i][1].setPosition(timeStartX + digitSpacing, rowY);
 
 
-                timeSprites[i][2].setTexture(numeralTextures[second1]);
+                numeralTextures[second1].applyTo(timeSprites[i][2]);
                 timeSprites[i][2].setScale(0.7f, 0.7f);
                 timeSprites[i][2].setPosition(timeStartX + digitSpacing * 2.5f, rowY);
 
-                timeSprites[i][3].setTexture(numeralTextures[second2]);
+                numeralTextures[second2].applyTo(timeSprites[i][3]);
                 timeSprites[i][3].setScale(0.7f, 0.7f);
                 timeSprites[i][3].setPosition(timeStartX + digitSpacing * 3.5f, rowY);
             }
@@ -4305,188 +7567,41 @@ public:
         }
     }
 
+    /// purpose: starfield, then the cached table as a single sprite; the table is redrawn first if it changed.
+    ///          Drawing over a transparent texture leaves it premultiplied, so the sprite is blended as such to keep
+    ///          anti-aliased text edges from darkening.
     void draw(sf::RenderWindow& window) {
+        Starfield::shared().draw(window);
 
-        static bool starsInit = false;
-        static sf::CircleShape stars[200];
-        if (!starsInit) {
-            srand((unsigned int)time(nullptr) + 100);
-            for (int i = 0; i < 200; i++) {
-                float r = 1.0f + (rand() % 3);
-                stars[i].setRadius(r);
-                stars[i].setPosition((float)(rand() % 1920), (float)(rand() % 1080));
-                int b = 150 + rand() % 100;
-                stars[i].setFillColor(sf::Color((sf::Uint8)b, (sf::Uint8)b, (sf::Uint8)b));
+        if (tableDirty) {
+            if (!tableTextureReady) {
+                tableTextureReady = tableTexture.create(1920, 1080);
+                tableTexture.setSmooth(true);
             }
-            starsInit = true;
-        }
-
-        for (int i = 0; i < 200; i++) {
-            window.draw(stars[i]);
+            if (tableTextureReady) {
+                tableTexture.clear(sf::Color::Transparent);
+                drawTable(tableTexture);
+                tableTexture.display();
+                tableSprite.setTexture(tableTexture.getTexture(), true);
+            }
+            tableDirty = false;
         }
 
-        window.draw(titleText);
-        for (int i = 0; i < 4; i++) {
-            window.draw(headers[i]);
+        if (tableTextureReady) {
+            window.draw(tableSprite, sf::BlendMode(sf::BlendMode::One, sf::BlendMode::OneMinusSrcAlpha));
         }
-
-
-        for (int i = 0; i < 10; i++) {
-            int dataIndex = scrollOffset + i;
-            float rowY = 270.0f + i * 65.0f;
-
-            if (dataIndex < count) {
-
-                string rankStr = std::to_string(dataIndex + 1);
-                for (int d = 0; d < (int)rankStr.length() && d < 2; d++) {
-                    window.draw(rankSprites[i][d]);
-                }
-
-
-                sf::Text dotText;
-                dotText.setFont(font);
-                dotText.setString(".");
-                dotText.setCharacterSize(28);
-                dotText.setFillColor(sf::Color::White);
-                dotText.setPosition(400.0f + rankStr.length() * 25.0f, rowY);
-                window.draw(dotText);
-
-
-                window.draw(nameEntries[i]);
-
-
-                if (scores[dataIndex] > 0) {
-                    string scoreStr = std::to_string(scores[dataIndex]);
-                    for (int j = 0; j < (int)scoreStr.length() && j < 6; j++) {
-                        window.draw(scoreSprites[i][j]);
-                    }
-                }
-                else {
-                    window.draw(scoreSprites[i][0]);
-                }
-
-
-                for (int j = 0; j < 4; j++) {
-                    window.draw(timeSprites[i][j]);
-                }
-
-
-                float timeStartX = 1300.0f;
-                float digitSpacing = 25.0f;
-                sf::CircleShape colonDot1(2.5f);
-                colonDot1.setFillColor(sf::Color::White);
-                colonDot1.setPosition(timeStartX + digitSpacing * 2.1f, rowY + 8.0f);
-                window.draw(colonDot1);
-
-                sf::CircleShape colonDot2(2.5f);
-                colonDot2.setFillColor(sf::Color::White);
-                colonDot2.setPosition(timeStartX + digitSpacing * 2.1f, rowY + 18.0f);
-                window.draw(colonDot2);
-            }
-            else if (dataIndex >= count && i == 0 && count == 0) {
-
-                window.draw(nameEntries[i]);
-            }
+        else {
+            drawTable(window);
         }
-
-        window.draw(scrollText);
     }
 };
 
 
 
 
-void saveHighScore(const string& playerName, int score, float timeInSeconds) {
-    const int MAX_SCORES = 50;
-
-    try {
-
-        string* names = new string[MAX_SCORES];
-        int* scores = new int[MAX_SCORES]();
-        int* times = new int[MAX_SCORES]();
-        int count = 0;
-
-
-        try {
-            ifstream fileIn("highscores.txt");
-            if (!fileIn) {
-                throw FileLoadException("highscores.txt");
-            }
-
-            string line;
-            while (count < MAX_SCORES && getline(fileIn, line)) {
-                size_t lastSpacePos = line.rfind(' ');
-                if (lastSpacePos != string::npos) {
-                    size_t secondLastSpace = line.rfind(' ', lastSpacePos - 1);
-                    if (secondLastSpace != string::npos) {
-                        names[count] = line.substr(0, secondLastSpace);
-                        scores[count] = stoi(line.substr(secondLastSpace + 1, lastSpacePos - secondLastSpace - 1));
-                        times[count] = stoi(line.substr(lastSpacePos + 1));
-                        count++;
-                    }
-                }
-            }
-            fileIn.close();
-        }
-        catch (const FileLoadException& e) {
-            cout << "Note: " << e.what() << " (creating new file)" << endl;
-        }
-
-
-        int intTime = (int)timeInSeconds;
-
-
-        bool scoreAdded = false;
-        for (int i = 0; i < MAX_SCORES; i++) {
-            if (score > scores[i] || (score == scores[i] && intTime < times[i])) {
-
-                for (int j = MAX_SCORES - 1; j > i; j--) {
-                    names[j] = names[j - 1];
-                    scores[j] = scores[j - 1];
-                    times[j] = times[j - 1];
-                }
-                names[i] = playerName;
-                scores[i] = score;
-                times[i] = intTime;
-                scoreAdded = true;
-                if (count < MAX_SCORES) count++;
-                break;
-            }
-        }
-
-        if (!scoreAdded && count < MAX_SCORES) {
-            names[count] = playerName;
-            scores[count] = score;
-            times[count] = intTime;
-            count++;
-        }
-
-
-        try {
-            ofstream fileOut("highscores.txt");
-            if (!fileOut) {
-                throw FileLoadException("highscores.txt (write)");
-            }
-
-            for (int i = 0; i < count; i++) {
-                fileOut << names[i] << " " << scores[i] << " " << times[i] << endl;
-            }
-            fileOut.close();
-            cout << "High score saved successfully!" << endl;
-        }
-        catch (const FileLoadException& e) {
-            cout << "ERROR: " << e.what() << endl;
-        }
-
-
-        delete[] names;
-        delete[] scores;
-        delete[] times;
-
-    }
-    catch (const exception& e) {
-        cout << "Unexpected error in saveHighScore: " << e.what() << endl;
-    }
+/// purpose: record a finished game; returns at once, the journal's writer thread does the disk work.
+void saveHighScore(const string& playerName, int score, float timeInSeconds) {
+    ScoreJournal::shared().submit(playerName, score, (int)timeInSeconds);
 }
 
 
@@ -4500,7 +7615,7 @@ private:
     sf::RectangleShape backgroundOverlay;
 
 
-    sf::Texture shipTextures[4];
+    TextureHandle shipTextures[4];
     sf::Sprite shipSprites[4];
     sf::RectangleShape shipBoxes[4];
     sf::Text shipLabels[4];
@@ -4529,7 +7644,7 @@ public:
     }
 
     bool loadFont(const string& fontPath) {
-        if (!font.loadFromFile(fontPath)) {
+        if (!loadFontAsset(font, fontPath)) {
             return false;
         }
         return true;
@@ -4576,7 +7691,7 @@ public:
 
         for (int i = 0; i < 4; i++) {
 
-            shipSprites[i].setTexture(shipTextures[i]);
+            shipTextures[i].applyTo(shipSprites[i]);
             sf::FloatRect bounds = shipSprites[i].getLocalBounds();
             shipSprites[i].setOrigin(bounds.width / 2.0f, bounds.height / 2.0f);
             shipSprites[i].setPosition(startX + i * spacing, shipY);
@@ -4659,24 +7774,7 @@ public:
 
 private:
     void drawStars(sf::RenderWindow& win) {
-        static bool init = false;
-        static sf::CircleShape stars[150];
-
-        if (!init) {
-            srand((unsigned int)time(nullptr) + 999);
-            for (int i = 0; i < 150; i++) {
-                float r = 1.0f + (rand() % 3);
-                stars[i].setRadius(r);
-                stars[i].setPosition((float)(rand() % 1920), (float)(rand() % 1080));
-                int b = 150 + rand() % 100;
-                stars[i].setFillColor(sf::Color((sf::Uint8)b, (sf::Uint8)b, (sf::Uint8)b));
-            }
-            init = true;
-        }
-
-        for (int i = 0; i < 150; i++) {
-            win.draw(stars[i]);
-        }
+        Starfield::shared().draw(win);
     }
 };
 
@@ -4697,7 +7795,7 @@ public:
     VictoryScreen() : windowWidth(1920.0f), windowHeight(1080.0f) {}
 
     bool loadFont(const string& fontPath) {
-        if (!font.loadFromFile(fontPath)) {
+        if (!loadFontAsset(font, fontPath)) {
             return false;
         }
         return true;
@@ -4784,11 +7882,11 @@ public:
     }
 
     bool loadFont(const string& fontPath) {
-        if (font.loadFromFile(fontPath)) {
+        if (loadFontAsset(font, fontPath)) {
             fontLoaded = true;
             return true;
         }
-        if (font.loadFromFile("arial.ttf")) {
+        if (loadFontAsset(font, "arial.ttf")) {
             fontLoaded = true;
             return true;
         }
@@ -4881,22 +7979,7 @@ public:
         window.draw(backgroundOverlay);
 
 
-        static bool starsInit = false;
-        static sf::CircleShape stars[150];
-        if (!starsInit) {
-            srand((unsigned int)time(nullptr) + 500);
-            for (int i = 0; i < 150; i++) {
-                float r = 1.0f + (rand() % 3);
-                stars[i].setRadius(r);
-                stars[i].setPosition((float)(rand() % 1920), (float)(rand() % 1080));
-                int b = 150 + rand() % 100;
-                stars[i].setFillColor(sf::Color((sf::Uint8)b, (sf::Uint8)b, (sf::Uint8)b));
-            }
-            starsInit = true;
-        }
-        for (int i = 0; i < 150; i++) {
-            window.draw(stars[i]);
-        }
+        Starfield::shared().draw(window);
 
         window.draw(titleText);
         for (int i = 0; i < 3; i++) {
@@ -4923,10 +8006,10 @@ public:
     CreditsScreen() : windowWidth(1920.0f), windowHeight(1080.0f) {}
 
     bool loadFont(const string& fontPath) {
-        if (font.loadFromFile(fontPath)) {
+        if (loadFontAsset(font, fontPath)) {
             return true;
         }
-        if (font.loadFromFile("arial.ttf")) {
+        if (loadFontAsset(font, "arial.ttf")) {
             return true;
         }
         return false;
@@ -5008,22 +8091,7 @@ public:
         window.draw(backgroundOverlay);
 
 
-        static bool starsInit = false;
-        static sf::CircleShape stars[150];
-        if (!starsInit) {
-            srand((unsigned int)time(nullptr) + 700);
-            for (int i = 0; i < 150; i++) {
-                float r = 1.0f + (rand() % 3);
-                stars[i].setRadius(r);
-                stars[i].setPosition((float)(rand() % 1920), (float)(rand() % 1080));
-                int b = 150 + rand() % 100;
-                stars[i].setFillColor(sf::Color((sf::Uint8)b, (sf::Uint8)b, (sf::Uint8)b));
-            }
-            starsInit = true;
-        }
-        for (int i = 0; i < 150; i++) {
-            window.draw(stars[i]);
-        }
+        Starfield::shared().draw(window);
 
         window.draw(titleText);
         for (int i = 0; i < 15; i++) {
@@ -5035,8 +8103,131 @@ public:
 
 
 
+/// files the game needs before leaving the menu; AssetLoader decodes them in the background at startup.
+const char* const STARTUP_ASSETS[] = {
+    "MaginerfreeRegular-ALodL.ttf", "Steelar-j9Vnj.ttf", "arial.ttf", "typing_sound.wav", "sfx_laser1.ogg",
+    "bg1.jpg", "bg2.jpg", "bg5.jpg",
+    "playerShip1_red.png", "playerShip1_blue.png", "playerShip1_green.png", "playerShip1_orange.png",
+    "playerShip1_damage3.png", "playerShip2_damage1.png", "playerLife1_red.png", "shield3.png",
+    "meteorBrown_big1.png", "meteorBrown_small1.png", "laserRed02.png",
+    "enemyRed1.png", "enemyBlue1.png", "enemyGreen1.png", "enemyBlack1.png", "boss_blue.png",
+    "powerupRed_bolt.png", "powerupGreen_shield.png", "pill_blue.png", "bolt_gold.png",
+    "numeral0.png", "numeral1.png", "numeral2.png", "numeral3.png", "numeral4.png",
+    "numeral5.png", "numeral6.png", "numeral7.png", "numeral8.png", "numeral9.png", "numeralX.png"
+};
+const int STARTUP_ASSET_COUNT = sizeof(STARTUP_ASSETS) / sizeof(STARTUP_ASSETS[0]);
+
+/// Game::loadStep runs these one after another on the main thread, as many per frame as fit LOADING_FRAME_BUDGET.
+const int GAME_LOADING_STEPS = 12;
+const float LOADING_FRAME_BUDGET = 0.008f;
+
+const char* const LEVEL_BACKGROUNDS[3] = { "bg2.jpg", "bg1.jpg", "bg5.jpg" };
+/// texture memory the game may hold while a transition prefetches the next level next to the finished one;
+/// above it, the finished level is released first and the next one is built when the transition ends.
+const size_t LEVEL_TEXTURE_BUDGET = 64u * 1024u * 1024u;
+
+
+
+
+/// most ticks one frame can run: MAX_FRAME_DT / SIMULATION_DT, rounded up.
+const int MAX_FRAME_TICKS = 32;
+
+
+/// purpose: runs one frame's level ticks on a second thread while the main thread draws the previous frame, then
+///          records a snapshot of the result and publishes it through a triple buffer.
+/// parameters: start() copies the inputs of the ticks to run. A batch stops on the tick that ends the level (won,
+///             lost or replay over), so the game sees the same tick it would have stopped on ticking inline.
+/// return: wait() blocks until the batch is done; until then the level is only drawn from the snapshot start() returned.
+class SimulationWorker {
+private:
+    Level1* level;
+    PlayerInput inputs[MAX_FRAME_TICKS];
+    int tickCount;
+    bool bossLevel;
+    bool stopping;
+    mutex jobLock;
+    condition_variable jobChanged;
+    std::thread worker;
+    TripleBuffer<LevelSnapshot> snapshots;
+
+    static bool levelEnded(const Level1& level, bool bossLevel) {
+        if (level.isPlayerDestroyed() || level.isReplayFinished()) return true;
+        return bossLevel ? level.isBossDefeated() : level.getScore() >= level.calculateTargetScore();
+    }
+
+    void workerLoop() {
+        PROFILER_REGISTER_THREAD();
+        unique_lock<mutex> guard(jobLock);
+        while (true) {
+            jobChanged.wait(guard, [this]() { return level != nullptr || stopping; });
+            if (stopping) break;
+
+            guard.unlock();
+            for (int i = 0; i < tickCount; i++) {
+                level->update(SIMULATION_DT, inputs[i]);
+                if (levelEnded(*level, bossLevel)) break;
+            }
+            level->recordSnapshot(snapshots.back());
+            snapshots.publish();
+            guard.lock();
+
+            level = nullptr;
+            jobChanged.notify_all();
+        }
+    }
+
+public:
+    SimulationWorker() : level(nullptr), tickCount(0), bossLevel(false), stopping(false) {
+        worker = std::thread(&SimulationWorker::workerLoop, this);
+    }
+
+    ~SimulationWorker() {
+        {
+            lock_guard<mutex> guard(jobLock);
+            stopping = true;
+        }
+        jobChanged.notify_all();
+        worker.join();
+    }
+
+    /// purpose: queue a batch. When the newest snapshot is not of this level as it stands (first batch after a
+    ///          reset or a level change), one is recorded here first, so the frame never shows another run.
+    /// return: the snapshot to draw while the batch runs, taken before the worker is woken, so a batch that
+    ///         finishes early cannot swap in a frame the game has not finished yet.
+    const LevelSnapshot& start(Level1& target, const PlayerInput* tickInputs, int ticks, bool isBossLevel) {
+        if (!target.isSnapshotOf(snapshots.latest())) {
+            target.recordSnapshot(snapshots.back());
+            snapshots.publish();
+        }
+        const LevelSnapshot& shown = snapshots.latest();
+
+        lock_guard<mutex> guard(jobLock);
+        tickCount = ticks < MAX_FRAME_TICKS ? ticks : MAX_FRAME_TICKS;
+        for (int i = 0; i < tickCount; i++) {
+            inputs[i] = tickInputs[i];
+        }
+        bossLevel = isBossLevel;
+        level = &target;
+        jobChanged.notify_all();
+        return shown;
+    }
+
+    void wait() {
+        unique_lock<mutex> guard(jobLock);
+        jobChanged.wait(guard, [this]() { return level == nullptr; });
+    }
+
+};
+
+
+
+
 /// purpose: central controller managing the state flow (menu -> intro -> level1 -> level2 -> level3) and pausing.
 /// parameters: keeps a single sfml render window and shares references with states to avoid copying heavy resources.
+///             Only the menu is built before the first frame; everything else loads while it is shown, and picking
+///             a menu entry before that finishes goes through the loading screen (state 16).
+///             Levels are built on first use. The next one's background is decoded on a background thread during
+///             the transition cinematic, and a finished level is deleted once the next one starts or the run ends.
 class Game {
 private:
     sf::RenderWindow window;
@@ -5044,11 +8235,16 @@ private:
     ShipSelection shipSelection;
     sf::Music backgroundMusic;
     IntroSequence intro;
-    Level1 level1;
-    Level1 level2;
+    Level1* level1;
+    Level1* level2;
     Level2Transition level2Transition;
-    Level1 level3;
+    Level1* level3;
     Level2Transition level3Transition;
+    Level1* activeLevel;
+    RandomStream levelSeeds;
+    size_t levelFootprint;
+    std::thread levelWarmer;
+    int warmedLevel;
     VictoryStory victoryStory;
     TypewriterText level3StartText;
     sf::Font level3StartFont;
@@ -5061,16 +8257,33 @@ private:
     VictoryScreen victoryScreen;
     int state;
     bool isPaused;
+    ActionInput actionInput;
+    double inputPolledAt;
+    SimulationWorker simulation;
+    Level1* simulatedLevel;
+    const LevelSnapshot* shownSnapshot;
+    float snapshotAlpha;
+    float renderAlpha;
+    bool showDrawStats;
+    sf::Clock drawStatsClock;
     int totalScore;
     float totalTime;
     string selectedShipColor;
+    string playerName;
 
     HighScoreScreen highScoreScreen;
     bool scoreWasSaved;
     int selectedLevel;
 
+    int loadingStep;
+    int pendingState;
+    sf::Font loadingFont;
+    sf::Text loadingText;
+    sf::RectangleShape loadingBarBack;
+    sf::RectangleShape loadingBarFill;
+
     void drawLevel3() {
-        level3.draw(window);
+        drawLevel(level3);
     }
     LevelSelection levelSelection;
     CreditsScreen creditsScreen;
@@ -5079,17 +8292,37 @@ public:
 
     Game()
         : window(sf::VideoMode(1920, 1080), "Galaxy Wars: The Ultimate Space Battle"),
+        level1(nullptr),
+        level2(nullptr),
+        level3(nullptr),
+        activeLevel(nullptr),
+        levelFootprint(0),
+        warmedLevel(0),
         state(0),
         isPaused(false),
+        inputPolledAt(0.0),
+        simulatedLevel(nullptr),
+        shownSnapshot(nullptr),
+        snapshotAlpha(1.0f),
+        renderAlpha(1.0f),
+        showDrawStats(false),
         totalScore(0),
         totalTime(0.0f),
         selectedShipColor("Red"),
+        playerName("Player"),
         selectedLevel(0),
-        scoreWasSaved(false)
+        scoreWasSaved(false),
+        loadingStep(0),
+        pendingState(0)
     {
         window.setFramerateLimit(60);
+        Starfield::shared().setMotion(true, true);
+        levelSeeds.reseed((unsigned int)time(nullptr), 0);
 
-        if (backgroundMusic.openFromFile("background_music.ogg")) {
+        // start the score writer now, so an old highscores.txt is imported while the menu is up.
+        ScoreJournal::shared();
+
+        if (openMusicAsset(backgroundMusic, "background_music.ogg")) {
             backgroundMusic.setLoop(true);
             backgroundMusic.setVolume(50.0f);
             backgroundMusic.play();
@@ -5101,120 +8334,349 @@ public:
         if (!menu.loadFonts("Steelar-j9Vnj.ttf", "MaginerfreeRegular-ALodL.ttf")) {
             menu.loadFonts("arial.ttf", "arial.ttf");
         }
-
         menu.initialize(1920.0f, 1080.0f);
-        if (!creditsScreen.loadFont("Steelar-j9Vnj.ttf")) {
-            creditsScreen.loadFont("arial.ttf");
-        }
-        creditsScreen.initialize(1920.0f, 1080.0f);
 
-        selectedLevel = 0;
-        if (!levelSelection.loadFont("Steelar-j9Vnj.ttf")) {
-            levelSelection.loadFont("arial.ttf");
+        if (!loadFontAsset(loadingFont, "MaginerfreeRegular-ALodL.ttf")) {
+            loadFontAsset(loadingFont, "arial.ttf");
         }
-        levelSelection.initialize(1920.0f, 1080.0f);
+        loadingText.setFont(loadingFont);
+        loadingText.setCharacterSize(40);
+        loadingText.setFillColor(sf::Color::Cyan);
+        loadingBarBack.setSize(sf::Vector2f(600.0f, 16.0f));
+        loadingBarBack.setPosition(660.0f, 560.0f);
+        loadingBarBack.setFillColor(sf::Color(50, 50, 50, 200));
+        loadingBarBack.setOutlineThickness(2.0f);
+        loadingBarBack.setOutlineColor(sf::Color::White);
+        loadingBarFill.setPosition(660.0f, 560.0f);
+        loadingBarFill.setFillColor(sf::Color(50, 255, 100));
 
-        if (!shipSelection.loadFont("Steelar-j9Vnj.ttf")) {
-            shipSelection.loadFont("arial.ttf");
+        string paths[STARTUP_ASSET_COUNT];
+        int pathCount = 0;
+        for (int i = 0; i < STARTUP_ASSET_COUNT; i++) {
+            string source = TextureCache::instance().sourceFileFor(STARTUP_ASSETS[i]);
+            if (find(paths, paths + pathCount, source) == paths + pathCount) {
+                paths[pathCount++] = source;
+            }
         }
-        shipSelection.loadShipTextures();
-        shipSelection.initialize(1920.0f, 1080.0f);
+        AssetLoader::shared().start(paths, pathCount);
+    }
 
-        if (!intro.loadFont("MaginerfreeRegular-ALodL.ttf")) {
-            intro.loadFont("arial.ttf");
+    ~Game() {
+        finishWarming();
+        for (int n = 1; n <= 3; n++) {
+            releaseLevel(n);
         }
+    }
 
-        intro.loadTypingSound("typing_sound.wav");
-        level1.loadWaveFont("Steelar-j9Vnj.ttf");
-        level2.loadWaveFont("Steelar-j9Vnj.ttf");
+    Level1*& levelSlot(int number) {
+        return (number == 1) ? level1 : ((number == 2) ? level2 : level3);
+    }
 
-        level1.loadAssets();
+    /// purpose: build level 1..3 on first use, for the selected ship; textures another resident level holds are shared.
+    Level1& ensureLevel(int number) {
+        Level1*& level = levelSlot(number);
+        if (level != nullptr) return *level;
 
+        size_t before = TextureCache::instance().getResidentBytes();
+        level = new Level1();
+        level->setSeed(levelSeeds.next());
+        level->setRecording(true);
+        level->loadWaveFont("Steelar-j9Vnj.ttf");
+        level->loadAssets(LEVEL_BACKGROUNDS[number - 1], selectedShipColor);
+        if (number == 2) {
+            level->configureDifficulty(0.8f, 0.8f, 540.0f, "Blue", 3);
+        }
+        else if (number == 3) {
+            level->configureDifficulty(0.6f, 0.8f, 600.0f, "Green", 3);
+        }
 
-        if (!level2Transition.loadFont("MaginerfreeRegular-ALodL.ttf")) {
-            level2Transition.loadFont("arial.ttf");
+        size_t after = TextureCache::instance().getResidentBytes();
+        if (after > before && after - before > levelFootprint) {
+            levelFootprint = after - before;
         }
-        level2Transition.loadSound("typing_sound.wav");
+        return *level;
+    }
 
+    void releaseLevel(int number) {
+        Level1*& level = levelSlot(number);
+        if (level == nullptr) return;
 
-        level2.loadAssets("bg1.jpg");
-        level2.configureDifficulty(0.8f, 0.8f, 540.0f, "Blue", 3);
+        if (activeLevel == level) activeLevel = nullptr;
+        delete level;
+        level = nullptr;
+    }
 
+    /// purpose: build a level ahead of time, but only if it fits LEVEL_TEXTURE_BUDGET beside what is resident.
+    void prefetchLevel(int number) {
+        if (levelSlot(number) != nullptr) return;
+        if (TextureCache::instance().getResidentBytes() + levelFootprint > LEVEL_TEXTURE_BUDGET) return;
+        ensureLevel(number);
+    }
 
+    /// purpose: while a transition cinematic plays, decode the next level's background on a background thread so
+    ///          PixelCache holds its pixels; building the level when the cinematic ends then only copies and uploads.
+    void warmLevel(int number) {
+        if (warmedLevel == number || levelSlot(number) != nullptr) return;
 
-        if (level2StartFont.loadFromFile("Steelar-j9Vnj.ttf")) {
-            level2StartText.setup("LEVEL 2 STARTED", level2StartFont, 72, sf::Color::Cyan);
-            level2StartText.setPosition(1920.0f * 0.5f, 1080.0f * 0.5f);
-        }
-        else if (level2StartFont.loadFromFile("arial.ttf")) {
-            level2StartText.setup("LEVEL 2 STARTED", level2StartFont, 72, sf::Color::Cyan);
-            level2StartText.setPosition(1920.0f * 0.5f, 1080.0f * 0.5f);
+        finishWarming();
+        warmedLevel = number;
+        string source = TextureCache::instance().sourceFileFor(LEVEL_BACKGROUNDS[number - 1]);
+        levelWarmer = std::thread([source]() {
+            sf::Image image;
+            PixelCache::shared().decode(source, image);
+        });
+    }
+
+    void finishWarming() {
+        if (levelWarmer.joinable()) levelWarmer.join();
+    }
+
+    /// purpose: start a new run at level `number`; every other level is released and a resident one is re-skinned.
+    Level1& startFreshLevel(int number) {
+        for (int n = 1; n <= 3; n++) {
+            if (n != number) releaseLevel(n);
         }
 
-        if (!level3Transition.loadFont("MaginerfreeRegular-ALodL.ttf")) {
-            level3Transition.loadFont("arial.ttf");
+        bool wasResident = levelSlot(number) != nullptr;
+        Level1& level = ensureLevel(number);
+        if (wasResident) {
+            level.loadAssets(LEVEL_BACKGROUNDS[number - 1], selectedShipColor);
         }
-        level3Transition.loadSound("typing_sound.wav");
+        activeLevel = &level;
+        return level;
+    }
 
+    /// purpose: end the transition into level `number`: free the finished level, then make sure the next one exists.
+    Level1& advanceToLevel(int number) {
+        finishWarming();
+        releaseLevel(number - 1);
+        Level1& level = ensureLevel(number);
+        activeLevel = &level;
+        return level;
+    }
 
-        level3.loadAssets("bg5.jpg", "Green");
-        level3.configureDifficulty(0.6f, 0.8f, 600.0f, "Green", 3);
-        level3.loadWaveFont("Steelar-j9Vnj.ttf");
+    bool assetsReady() const {
+        return loadingStep >= GAME_LOADING_STEPS;
+    }
 
+    /// purpose: build everything but the menu from the files AssetLoader prepared; each step uploads its textures.
+    void loadStep(int step) {
+        switch (step) {
+        case 0:
+            if (!creditsScreen.loadFont("Steelar-j9Vnj.ttf")) {
+                creditsScreen.loadFont("arial.ttf");
+            }
+            creditsScreen.initialize(1920.0f, 1080.0f);
 
-        if (level3StartFont.loadFromFile("Steelar-j9Vnj.ttf")) {
-            level3StartText.setup("LEVEL 3 - BOSS FIGHT", level3StartFont, 72, sf::Color::Red);
-            level3StartText.setPosition(1920.0f * 0.5f, 1080.0f * 0.5f);
-        }
-        else if (level3StartFont.loadFromFile("arial.ttf")) {
-            level3StartText.setup("LEVEL 3 - BOSS FIGHT", level3StartFont, 72, sf::Color::Red);
-            level3StartText.setPosition(1920.0f * 0.5f, 1080.0f * 0.5f);
-        }
+            if (!levelSelection.loadFont("Steelar-j9Vnj.ttf")) {
+                levelSelection.loadFont("arial.ttf");
+            }
+            levelSelection.initialize(1920.0f, 1080.0f);
+            break;
 
-        if (!victoryStory.loadFont("MaginerfreeRegular-ALodL.ttf")) {
-            victoryStory.loadFont("arial.ttf");
-        }
-        victoryStory.loadTypingSound("typing_sound.wav");
+        case 1:
+            if (!shipSelection.loadFont("Steelar-j9Vnj.ttf")) {
+                shipSelection.loadFont("arial.ttf");
+            }
+            shipSelection.loadShipTextures();
+            shipSelection.initialize(1920.0f, 1080.0f);
+            break;
+
+        case 2:
+            if (!intro.loadFont("MaginerfreeRegular-ALodL.ttf")) {
+                intro.loadFont("arial.ttf");
+            }
+            intro.loadTypingSound("typing_sound.wav");
+            break;
 
+        case 3:
+            prefetchLevel(1);
+            break;
 
-        if (!pauseMenu.loadFont("MaginerfreeRegular-ALodL.ttf")) {
-            pauseMenu.loadFont("arial.ttf");
-        }
-        pauseMenu.initialize(1920.0f, 1080.0f);
+        case 4:
+            if (!level2Transition.loadFont("MaginerfreeRegular-ALodL.ttf")) {
+                level2Transition.loadFont("arial.ttf");
+            }
+            level2Transition.loadSound("typing_sound.wav");
+            break;
+
+        case 5:
+            if (loadFontAsset(level2StartFont, "Steelar-j9Vnj.ttf")) {
+                level2StartText.setup("LEVEL 2 STARTED", level2StartFont, 72, sf::Color::Cyan);
+                level2StartText.setPosition(1920.0f * 0.5f, 1080.0f * 0.5f);
+            }
+            else if (loadFontAsset(level2StartFont, "arial.ttf")) {
+                level2StartText.setup("LEVEL 2 STARTED", level2StartFont, 72, sf::Color::Cyan);
+                level2StartText.setPosition(1920.0f * 0.5f, 1080.0f * 0.5f);
+            }
+            break;
+
+        case 6:
+            if (!level3Transition.loadFont("MaginerfreeRegular-ALodL.ttf")) {
+                level3Transition.loadFont("arial.ttf");
+            }
+            level3Transition.loadSound("typing_sound.wav");
+            break;
+
+        case 7:
+            if (loadFontAsset(level3StartFont, "Steelar-j9Vnj.ttf")) {
+                level3StartText.setup("LEVEL 3 - BOSS FIGHT", level3StartFont, 72, sf::Color::Red);
+                level3StartText.setPosition(1920.0f * 0.5f, 1080.0f * 0.5f);
+            }
+            else if (loadFontAsset(level3StartFont, "arial.ttf")) {
+                level3StartText.setup("LEVEL 3 - BOSS FIGHT", level3StartFont, 72, sf::Color::Red);
+                level3StartText.setPosition(1920.0f * 0.5f, 1080.0f * 0.5f);
+            }
+            break;
+
+        case 8:
+            if (!victoryStory.loadFont("MaginerfreeRegular-ALodL.ttf")) {
+                victoryStory.loadFont("arial.ttf");
+            }
+            victoryStory.loadTypingSound("typing_sound.wav");
+            break;
 
+        case 9:
+            if (!pauseMenu.loadFont("MaginerfreeRegular-ALodL.ttf")) {
+                pauseMenu.loadFont("arial.ttf");
+            }
+            pauseMenu.initialize(1920.0f, 1080.0f);
+
+            if (!gameOverScreen.loadFont("MaginerfreeRegular-ALodL.ttf")) {
+                gameOverScreen.loadFont("arial.ttf");
+            }
+            gameOverScreen.initialize(1920.0f, 1080.0f);
+            break;
+
+        case 10:
+            if (!victoryScreen.loadFont("MaginerfreeRegular-ALodL.ttf")) {
+                victoryScreen.loadFont("arial.ttf");
+            }
+            victoryScreen.initialize(1920.0f, 1080.0f);
+
+            if (!highScoreScreen.loadFont("MaginerfreeRegular-ALodL.ttf")) {
+                highScoreScreen.loadFont("arial.ttf");
+            }
+            break;
 
-        if (!gameOverScreen.loadFont("MaginerfreeRegular-ALodL.ttf")) {
-            gameOverScreen.loadFont("arial.ttf");
+        case 11:
+            AssetLoader::shared().releaseDecoded();
+            break;
         }
-        gameOverScreen.initialize(1920.0f, 1080.0f);
+    }
 
+    /// purpose: once the workers are done, run loading steps until this frame's budget is spent.
+    void continueLoading() {
+        if (assetsReady() || !AssetLoader::shared().isDone()) return;
 
-        if (!victoryScreen.loadFont("MaginerfreeRegular-ALodL.ttf")) {
-            victoryScreen.loadFont("arial.ttf");
+        sf::Clock budget;
+        while (!assetsReady() && budget.getElapsedTime().asSeconds() < LOADING_FRAME_BUDGET) {
+            loadStep(loadingStep++);
         }
-        victoryScreen.initialize(1920.0f, 1080.0f);
-        scoreWasSaved = false;
+    }
 
+    /// purpose: finish loading right now, e.g. before a replay given on the command line starts.
+    void finishLoading() {
+        AssetLoader::shared().wait();
+        while (!assetsReady()) {
+            loadStep(loadingStep++);
+        }
+    }
 
+    /// purpose: switch to a state that needs the loaded assets, detouring through the loading screen until they are.
+    void enterState(int next) {
+        if (!assetsReady()) {
+            pendingState = next;
+            state = 16;
+            return;
+        }
 
-        if (!highScoreScreen.loadFont("MaginerfreeRegular-ALodL.ttf")) {
-            highScoreScreen.loadFont("arial.ttf");
+        if (next == 9) {
+            ScoreJournal::shared().flush();
+            highScoreScreen.loadScores();
+            highScoreScreen.initialize();
         }
+        state = next;
+    }
+
+    void drawLoading() {
+        Starfield::shared().draw(window);
+
+        AssetLoader& loader = AssetLoader::shared();
+        float progress = (float)(loader.getDone() + loadingStep) / (float)(loader.getTotal() + GAME_LOADING_STEPS);
+        loadingText.setString("LOADING " + std::to_string((int)(progress * 100.0f)) + "%");
+        sf::FloatRect bounds = loadingText.getLocalBounds();
+        loadingText.setOrigin(bounds.width / 2.0f, bounds.height / 2.0f);
+        loadingText.setPosition(960.0f, 500.0f);
+        loadingBarFill.setSize(sf::Vector2f(600.0f * progress, 16.0f));
 
+        window.draw(loadingText);
+        window.draw(loadingBarBack);
+        window.draw(loadingBarFill);
+    }
+
+    /// purpose: watch a recorded level session on screen instead of starting at the menu; level 1 plays it back
+    ///          and the game returns to the menu when it ends, without touching the high scores.
+    bool playReplay(const string& path) {
+        finishLoading();
+        activeLevel = &ensureLevel(1);
+        if (!level1->startReplay(path)) {
+            cout << "Cannot load replay " << path << endl;
+            return false;
+        }
+        scoreWasSaved = true;
+        selectedLevel = 1;
+        state = 3;
+        return true;
+    }
 
+    void finishReplay() {
+        long divergedAt = level1->getReplayDivergence();
+        if (divergedAt >= 0) {
+            cout << "Replay diverged at tick " << divergedAt << endl;
+        }
+        else {
+            cout << "Replay finished, score " << level1->getScore() << endl;
+        }
+        level1->stopReplay();
+        scoreWasSaved = false;
+        selectedLevel = 0;
+        state = 0;
     }
 
     /// purpose: main loop handling event polling, state updates, and draw order (background -> actors -> ui) per state.
     void run() {
         sf::Clock frameClock;
+        float simAccumulator = 0.0f;
 
         while (window.isOpen()) {
+            PROFILER_END_FRAME();
+            PROFILE_ZONE(PROFILE_FRAME);
+            finishLevelTicks();
             float dt = frameClock.restart().asSeconds();
+            if (dt > MAX_FRAME_DT) dt = MAX_FRAME_DT;
+
+            simAccumulator += dt;
+            int simSteps = 0;
+            while (simAccumulator >= SIMULATION_DT) {
+                simAccumulator -= SIMULATION_DT;
+                simSteps++;
+            }
+            float shownAlpha = renderAlpha;
+            renderAlpha = 1.0f;
+
             handleEvents();
+            inputPolledAt = actionInput.now();
+            continueLoading();
 
             if (state == 0) {
                 menu.update(dt);
             }
+            else if (state == 16) {
+                if (assetsReady()) {
+                    enterState(pendingState);
+                }
+            }
             else if (state == 1) {
 
                 shipSelection.update(dt);
@@ -5222,52 +8684,14 @@ public:
             else if (state == 2) {
                 intro.update();
                 if (intro.isFinished()) {
-                    level1.startTimer();
+                    level1->startTimer();
                     state = 3;
                 }
             }
             else if (state == 3) {
                 if (!isPaused) {
-                    level1.update(dt);
-                    int level1Target = level1.calculateTargetScore();
-                    if (level1.getScore() >= level1Target && !level1.isPlayerDestroyed()) {
-                        totalScore = level1.getScore();
-                        totalTime = level1.getCurrentTime();
-                        level1.stopTimer();
-
-                        if (selectedLevel == 1) {
-
-                            if (!scoreWasSaved) {
-                                saveHighScore(currentPlayerName, totalScore, totalTime);
-                                scoreWasSaved = true;
-                            }
-                            gameOverScreen.setVictory(true);
-                            gameOverScreen.setScore(totalScore);
-                            gameOverScreen.setTime(totalTime);
-                            state = 4;
-                        }
-                        else {
-
-                            level2Transition.start(1920.0f, 1080.0f);
-                            state = 5;
-                        }
-                    }
-                    else if (level1.isPlayerDestroyed()) {
-                        totalScore = level1.getScore();
-                        totalTime = level1.getCurrentTime();
-                        level1.stopTimer();
-
-
-                        if (!scoreWasSaved) {
-                            saveHighScore(currentPlayerName, totalScore, totalTime);
-                            scoreWasSaved = true;
-                        }
-
-                        gameOverScreen.setVictory(false);
-                        gameOverScreen.setScore(totalScore);
-                        gameOverScreen.setTime(totalTime);
-                        state = 4;
-                    }
+                    startLevelTicks(*level1, simSteps, simAccumulator, shownAlpha);
+                    renderAlpha = simAccumulator / SIMULATION_DT;
                 }
                 else {
                     pauseMenu.update(dt);
@@ -5288,11 +8712,12 @@ public:
             else if (state == 5) {
 
                 level2Transition.update();
+                warmLevel(2);
                 if (level2Transition.isFinished()) {
-
-                    level2.reset();
-                    level2.continueTimer(totalTime);
-                    level2.setScoreOffset(totalScore);
+                    Level1& level = advanceToLevel(2);
+                    level.reset();
+                    level.continueTimer(totalTime);
+                    level.setScoreOffset(totalScore);
                     level2StartText.start();
                     level2StartTimer.restart();
                     state = 7;
@@ -5307,45 +8732,8 @@ public:
             }
             else if (state == 6) {
                 if (!isPaused) {
-                    level2.update(dt);
-                    int level2Target = level2.calculateTargetScore();
-                    if (level2.getScore() >= level2Target && !level2.isPlayerDestroyed()) {
-                        totalScore = totalScore + level2.getScore();
-                        totalTime = level2.getCurrentTime();
-                        level2.stopTimer();
-
-                        if (selectedLevel == 2) {
-
-                            if (!scoreWasSaved) {
-                                saveHighScore(currentPlayerName, totalScore, totalTime);
-                                scoreWasSaved = true;
-                            }
-                            gameOverScreen.setVictory(true);
-                            gameOverScreen.setScore(totalScore);
-                            gameOverScreen.setTime(totalTime);
-                            state = 4;
-                        }
-                        else {
-
-                            level3Transition.start(1920.0f, 1080.0f);
-                            state = 10;
-                        }
-                    }
-                    else if (level2.isPlayerDestroyed()) {
-                        totalScore = totalScore + level2.getScore();
-                        totalTime = level2.getCurrentTime();
-                        level2.stopTimer();
-
-                        if (!scoreWasSaved) {
-                            saveHighScore(currentPlayerName, totalScore, totalTime);
-                            scoreWasSaved = true;
-                        }
-
-                        gameOverScreen.setVictory(false);
-                        gameOverScreen.setScore(totalScore);
-                        gameOverScreen.setTime(totalTime);
-                        state = 4;
-                    }
+                    startLevelTicks(*level2, simSteps, simAccumulator, shownAlpha);
+                    renderAlpha = simAccumulator / SIMULATION_DT;
                 }
                 else {
                     pauseMenu.update(dt);
@@ -5365,10 +8753,12 @@ public:
             else if (state == 10) {
 
                 level3Transition.update();
+                warmLevel(3);
                 if (level3Transition.isFinished()) {
-                    level3.reset();
-                    level3.continueTimer(totalTime);
-                    level3.setScoreOffset(totalScore);
+                    Level1& level = advanceToLevel(3);
+                    level.reset();
+                    level.continueTimer(totalTime);
+                    level.setScoreOffset(totalScore);
                     level3StartText.start();
                     level3StartTimer.restart();
                     state = 12;
@@ -5387,8 +8777,8 @@ public:
                 if (levelChoice > 0) {
 
                     sf::Font tempFont;
-                    if (tempFont.loadFromFile("MaginerfreeRegular-ALodL.ttf") || tempFont.loadFromFile("arial.ttf")) {
-                        currentPlayerName = getPlayerName(window, tempFont);
+                    if (loadFontAsset(tempFont, "MaginerfreeRegular-ALodL.ttf") || loadFontAsset(tempFont, "arial.ttf")) {
+                        playerName = getPlayerName(window, tempFont);
                     }
                     totalScore = 0;
                     totalTime = 0.0f;
@@ -5404,33 +8794,8 @@ public:
             else if (state == 11) {
 
                 if (!isPaused) {
-                    level3.update(dt);
-
-
-                    if (level3.isBossDefeated() && !level3.isPlayerDestroyed()) {
-                        totalScore = totalScore + level3.getScore();
-                        totalTime = level3.getCurrentTime();
-                        level3.stopTimer();
-
-
-                        victoryStory.start(1920.0f, 1080.0f);
-                        state = 13;
-                    }
-                    else if (level3.isPlayerDestroyed()) {
-                        totalScore = totalScore + level3.getScore();
-                        totalTime = level3.getCurrentTime();
-                        level3.stopTimer();
-
-                        if (!scoreWasSaved) {
-                            saveHighScore(currentPlayerName, totalScore, totalTime);
-                            scoreWasSaved = true;
-                        }
-
-                        gameOverScreen.setVictory(false);
-                        gameOverScreen.setScore(totalScore);
-                        gameOverScreen.setTime(totalTime);
-                        state = 4;
-                    }
+                    startLevelTicks(*level3, simSteps, simAccumulator, shownAlpha);
+                    renderAlpha = simAccumulator / SIMULATION_DT;
                 }
                 else {
                     pauseMenu.update(dt);
@@ -5446,7 +8811,7 @@ public:
                 if (victoryStory.isFinished()) {
 
                     if (!scoreWasSaved) {
-                        saveHighScore(currentPlayerName, totalScore, totalTime);
+                        saveHighScore(playerName, totalScore, totalTime);
                         scoreWasSaved = true;
                     }
 
@@ -5457,12 +8822,16 @@ public:
                     state = 4;
                 }
             }
+            actionInput.endFrame();
 
             window.clear(sf::Color(5, 5, 25));
 
             if (state == 0) {
                 menu.draw(window);
             }
+            else if (state == 16) {
+                drawLoading();
+            }
             else if (state == 1) {
                 shipSelection.draw(window);
             }
@@ -5477,7 +8846,7 @@ public:
                 }
             }
             else if (state == 4) {
-                drawLevel1();
+                drawActiveLevel();
                 gameOverScreen.draw(window);
             }
             else if (state == 5) {
@@ -5535,10 +8904,24 @@ public:
                 }
             }
 
+
+            if (showDrawStats && drawStatsClock.getElapsedTime().asSeconds() >= 1.0f) {
+                TextureCache& textures = TextureCache::instance();
+                window.setTitle("Galaxy Wars: The Ultimate Space Battle - " + std::to_string(drawCallsThisFrame) +
+                    " level draw calls, " + std::to_string(textures.getResidentCount()) + " textures, " +
+                    std::to_string(textures.getLoadCount()) + " loads, " +
+                    std::to_string(textures.getAtlasRegionCount()) + " atlas regions");
+                drawStatsClock.restart();
+            }
+            drawCallsThisFrame = 0;
+
+            PROFILER_DRAW_OVERLAY(window);
             window.display();
         }
 
+        finishLevelTicks();
         backgroundMusic.stop();
+        PROFILER_EXPORT_CSV("profile_session.csv");
     }
 
 private:
@@ -5550,6 +8933,18 @@ private:
             if (e.type == sf::Event::Closed) {
                 window.close();
             }
+            actionInput.handleEvent(e);
+
+            if (e.type == sf::Event::KeyPressed && e.key.code == sf::Keyboard::F4) {
+                PROFILER_TOGGLE_OVERLAY();
+            }
+
+            if (e.type == sf::Event::KeyPressed && e.key.code == sf::Keyboard::F3) {
+                showDrawStats = !showDrawStats;
+                if (!showDrawStats) {
+                    window.setTitle("Galaxy Wars: The Ultimate Space Battle");
+                }
+            }
 
             if (e.type == sf::Event::KeyPressed) {
                 if (state == 0) {
@@ -5559,32 +8954,35 @@ private:
                         if (sel == 0) {
 
                             sf::Font tempFont;
-                            if (tempFont.loadFromFile("MaginerfreeRegular-ALodL.ttf") || tempFont.loadFromFile("arial.ttf")) {
-                                currentPlayerName = getPlayerName(window, tempFont);
+                            if (loadFontAsset(tempFont, "MaginerfreeRegular-ALodL.ttf") || loadFontAsset(tempFont, "arial.ttf")) {
+                                playerName = getPlayerName(window, tempFont);
                             }
                             totalScore = 0;
                             totalTime = 0.0f;
                             scoreWasSaved = false;
                             selectedLevel = 0;
-                            state = 1;
+                            enterState(1);
                         }
 
                         else if (sel == 1) {
-                            highScoreScreen.loadScores();
-                            highScoreScreen.initialize();
-                            state = 9;
+                            enterState(9);
                         }
                         else if (sel == 2) {
-                            state = 14;
+                            enterState(14);
                         }
                         else if (sel == 3) {
                             window.close();
                         }
                         else if (sel == 4) {
-                            state = 15;
+                            enterState(15);
                         }
                     }
                 }
+                else if (state == 16) {
+                    if (e.key.code == sf::Keyboard::Escape) {
+                        state = 0;
+                    }
+                }
                 else if (state == 1) {
 
                     shipSelection.handleInput(e.key.code);
@@ -5593,38 +8991,36 @@ private:
 
                         if (selectedLevel == 1) {
 
-                            level1.loadAssets("bg2.jpg", selectedShipColor);
-                            level1.reset();
-                            level1.setScoreOffset(0);
+                            Level1& level = startFreshLevel(1);
+                            level.reset();
+                            level.setScoreOffset(0);
                             intro.start(1920.0f, 1080.0f);
                             state = 2;
                         }
                         else if (selectedLevel == 2) {
 
-                            level2.loadAssets("bg1.jpg", selectedShipColor);
-                            level2.reset();
-                            level2.setScoreOffset(0);
-                            level2.startTimer();
+                            Level1& level = startFreshLevel(2);
+                            level.reset();
+                            level.setScoreOffset(0);
+                            level.startTimer();
                             level2StartText.start();
                             level2StartTimer.restart();
                             state = 7;
                         }
                         else if (selectedLevel == 3) {
 
-                            level3.loadAssets("bg5.jpg", selectedShipColor);
-                            level3.reset();
-                            level3.setScoreOffset(0);
-                            level3.startTimer();
+                            Level1& level = startFreshLevel(3);
+                            level.reset();
+                            level.setScoreOffset(0);
+                            level.startTimer();
                             level3StartText.start();
                             level3StartTimer.restart();
                             state = 12;
                         }
                         else {
 
-                            level1.loadAssets("bg2.jpg", selectedShipColor);
-                            level1.reset();
-                            level2.loadAssets("bg1.jpg", selectedShipColor);
-                            level3.loadAssets("bg5.jpg", selectedShipColor);
+                            Level1& level = startFreshLevel(1);
+                            level.reset();
                             intro.start(1920.0f, 1080.0f);
                             state = 2;
                         }
@@ -5636,17 +9032,15 @@ private:
                 }
                 else if (state == 3) {
 
-                    if (e.key.code == sf::Keyboard::P && !level1.isPlayerDestroyed()) {
+                    if (actionInput.isBound(ACTION_PAUSE, e.key.code) && !level1->isPlayerDestroyed()) {
                         isPaused = !isPaused;
                     }
 
                     if (e.key.code == sf::Keyboard::Escape && !isPaused) {
-                        menu.initialize(1920.0f, 1080.0f);
-                        state = 0;
+                        returnToMenu();
                     }
-
-                    if (e.key.code == sf::Keyboard::R && level1.isPlayerDestroyed()) {
-                        level1.reset();
+                    else if (e.key.code == sf::Keyboard::R && level1->isPlayerDestroyed()) {
+                        level1->reset();
                         intro.start(1920.0f, 1080.0f);
                         state = 2;
                     }
@@ -5661,15 +9055,14 @@ private:
                 }
                 else if (state == 6) {
 
-                    if (e.key.code == sf::Keyboard::P && !level2.isPlayerDestroyed()) {
+                    if (actionInput.isBound(ACTION_PAUSE, e.key.code) && !level2->isPlayerDestroyed()) {
                         isPaused = !isPaused;
                     }
                     if (e.key.code == sf::Keyboard::Escape && !isPaused) {
-                        menu.initialize(1920.0f, 1080.0f);
-                        state = 0;
+                        returnToMenu();
                     }
-                    if (e.key.code == sf::Keyboard::R && level2.isPlayerDestroyed()) {
-                        level2.reset();
+                    else if (e.key.code == sf::Keyboard::R && level2->isPlayerDestroyed()) {
+                        level2->reset();
                         level2StartText.start();
                         level2StartTimer.restart();
                         state = 7;
@@ -5719,16 +9112,15 @@ private:
                 }
                 else if (state == 11) {
 
-                    if (e.key.code == sf::Keyboard::P && !level3.isPlayerDestroyed()) {
+                    if (actionInput.isBound(ACTION_PAUSE, e.key.code) && !level3->isPlayerDestroyed()) {
                         isPaused = !isPaused;
                     }
 
                     if (e.key.code == sf::Keyboard::Escape && !isPaused) {
-                        menu.initialize(1920.0f, 1080.0f);
-                        state = 0;
+                        returnToMenu();
                     }
-                    if (e.key.code == sf::Keyboard::R && level3.isPlayerDestroyed()) {
-                        level3.reset();
+                    else if (e.key.code == sf::Keyboard::R && level3->isPlayerDestroyed()) {
+                        level3->reset();
                         level3StartText.start();
                         level3StartTimer.restart();
                         state = 12;
@@ -5738,14 +9130,200 @@ private:
         }
     }
 
+    /// purpose: hand this frame's ticks of the running level to the simulation thread; finishLevelTicks() collects
+    ///          them at the top of the next frame, and until then the level is drawn from the last published snapshot.
+    /// parameters: shownAlpha is the previous frame's interpolation, which belongs to that snapshot.
+    void startLevelTicks(Level1& level, int simSteps, float simAccumulator, float shownAlpha) {
+        if (simSteps <= 0) return;
+
+        PlayerInput inputs[MAX_FRAME_TICKS];
+        int ticks = simSteps < MAX_FRAME_TICKS ? simSteps : MAX_FRAME_TICKS;
+        for (int step = 0; step < ticks; step++) {
+            inputs[step] = tickInput(step, ticks, simAccumulator);
+        }
+        shownSnapshot = &simulation.start(level, inputs, ticks, state == 11);
+        simulatedLevel = &level;
+        snapshotAlpha = shownAlpha;
+    }
+
+    /// purpose: wait for the batch started last frame, then apply its outcome as the inline loop used to per tick.
+    void finishLevelTicks() {
+        if (simulatedLevel == nullptr) return;
+
+        simulation.wait();
+        simulatedLevel = nullptr;
+        if (state == 3) finishLevel1Ticks();
+        else if (state == 6) finishLevel2Ticks();
+        else if (state == 11) finishLevel3Ticks();
+    }
+
+    /// purpose: end of Level 1 once a batch has run: save the score and move on when it was won or lost.
+    void finishLevel1Ticks() {
+        if (level1->isReplayFinished()) {
+            finishReplay();
+            return;
+        }
+        int level1Target = level1->calculateTargetScore();
+        if (level1->getScore() >= level1Target && !level1->isPlayerDestroyed()) {
+            totalScore = level1->getScore();
+            totalTime = level1->getCurrentTime();
+            level1->stopTimer();
+            level1->saveReplay("replay_level1.gwr");
+
+            if (selectedLevel == 1) {
+
+                if (!scoreWasSaved) {
+                    saveHighScore(playerName, totalScore, totalTime);
+                    scoreWasSaved = true;
+                }
+                gameOverScreen.setVictory(true);
+                gameOverScreen.setScore(totalScore);
+                gameOverScreen.setTime(totalTime);
+                state = 4;
+            }
+            else {
+
+                level2Transition.start(1920.0f, 1080.0f);
+                state = 5;
+            }
+        }
+        else if (level1->isPlayerDestroyed()) {
+            totalScore = level1->getScore();
+            totalTime = level1->getCurrentTime();
+            level1->stopTimer();
+            level1->saveReplay("replay_level1.gwr");
+
+
+            if (!scoreWasSaved) {
+                saveHighScore(playerName, totalScore, totalTime);
+                scoreWasSaved = true;
+            }
+
+            gameOverScreen.setVictory(false);
+            gameOverScreen.setScore(totalScore);
+            gameOverScreen.setTime(totalTime);
+            state = 4;
+        }
+    }
+
+    /// purpose: end of Level 2 once a batch has run: save the score and move on when it was won or lost.
+    void finishLevel2Ticks() {
+        int level2Target = level2->calculateTargetScore();
+        if (level2->getScore() >= level2Target && !level2->isPlayerDestroyed()) {
+            totalScore = totalScore + level2->getScore();
+            totalTime = level2->getCurrentTime();
+            level2->stopTimer();
+            level2->saveReplay("replay_level2.gwr");
+
+            if (selectedLevel == 2) {
+
+                if (!scoreWasSaved) {
+                    saveHighScore(playerName, totalScore, totalTime);
+                    scoreWasSaved = true;
+                }
+                gameOverScreen.setVictory(true);
+                gameOverScreen.setScore(totalScore);
+                gameOverScreen.setTime(totalTime);
+                state = 4;
+            }
+            else {
+
+                level3Transition.start(1920.0f, 1080.0f);
+                state = 10;
+            }
+        }
+        else if (level2->isPlayerDestroyed()) {
+            totalScore = totalScore + level2->getScore();
+            totalTime = level2->getCurrentTime();
+            level2->stopTimer();
+            level2->saveReplay("replay_level2.gwr");
+
+            if (!scoreWasSaved) {
+                saveHighScore(playerName, totalScore, totalTime);
+                scoreWasSaved = true;
+            }
+
+            gameOverScreen.setVictory(false);
+            gameOverScreen.setScore(totalScore);
+            gameOverScreen.setTime(totalTime);
+            state = 4;
+        }
+    }
+
+    /// purpose: end of the boss level once a batch has run: save the score and move on when it was won or lost.
+    void finishLevel3Ticks() {
+        if (level3->isBossDefeated() && !level3->isPlayerDestroyed()) {
+            totalScore = totalScore + level3->getScore();
+            totalTime = level3->getCurrentTime();
+            level3->stopTimer();
+            level3->saveReplay("replay_level3.gwr");
+
+
+            victoryStory.start(1920.0f, 1080.0f);
+            state = 13;
+        }
+        else if (level3->isPlayerDestroyed()) {
+            totalScore = totalScore + level3->getScore();
+            totalTime = level3->getCurrentTime();
+            level3->stopTimer();
+            level3->saveReplay("replay_level3.gwr");
+
+            if (!scoreWasSaved) {
+                saveHighScore(playerName, totalScore, totalTime);
+                scoreWasSaved = true;
+            }
+
+            gameOverScreen.setVictory(false);
+            gameOverScreen.setScore(totalScore);
+            gameOverScreen.setTime(totalTime);
+            state = 4;
+        }
+    }
+
+    /// purpose: input for tick `step` of the simSteps this frame runs. Each tick ends where the fixed-step clock puts it;
+    ///          the last one ends at the poll, so everything read this frame reaches the level before it is drawn.
+    PlayerInput tickInput(int step, int simSteps, float simAccumulator) {
+        if (step + 1 >= simSteps) return actionInput.nextTick(inputPolledAt);
+        return actionInput.nextTick(inputPolledAt - simAccumulator - (simSteps - 1 - step) * (double)SIMULATION_DT);
+    }
+
+    /// purpose: draw a level; while the simulation thread is ticking it, from the snapshot picked when the batch started.
+    void drawLevel(Level1* level) {
+        if (level == nullptr) return;
+
+        if (level == simulatedLevel) {
+            level->drawSnapshot(window, *shownSnapshot, snapshotAlpha);
+        }
+        else {
+            level->draw(window, renderAlpha);
+        }
+    }
+
     /// purpose: render level1 content to the shared render window.
     void drawLevel1() {
-        level1.draw(window);
+        drawLevel(level1);
     }
 
     /// purpose: render level2 content to the shared render window.
     void drawLevel2() {
-        level2.draw(window);
+        drawLevel(level2);
+    }
+
+    /// purpose: render whichever level the game over screen belongs to.
+    void drawActiveLevel() {
+        drawLevel(activeLevel);
+    }
+
+    /// purpose: leave a run for the main menu; levels 2 and 3 are freed and level 1 stays resident for the next run.
+    void returnToMenu() {
+        isPaused = false;
+        if (level1 != nullptr) {
+            level1->stopReplay();
+        }
+        releaseLevel(2);
+        releaseLevel(3);
+        menu.initialize(1920.0f, 1080.0f);
+        state = 0;
     }
 
     /// purpose: respond to pause menu selections and adjust state transitions accordingly.
@@ -5759,14 +9337,15 @@ private:
             scoreWasSaved = false;
             totalScore = 0;
             totalTime = 0.0f;
-            level1.reset();
+            if (level1 != nullptr) {
+                level1->stopReplay();
+                level1->reset();
+            }
             intro.start(1920.0f, 1080.0f);
             state = 1;
         }
         else if (action == PAUSE_MAIN_MENU) {
-            isPaused = false;
-            menu.initialize(1920.0f, 1080.0f);
-            state = 0;
+            returnToMenu();
         }
         else if (action == PAUSE_EXIT) {
             window.close();
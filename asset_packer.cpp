@@ -0,0 +1,157 @@
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+using namespace std;
+
+
+/// Build-time tool: concatenates the asset files of a folder into assets.pak, which AssetPack maps at startup,
+/// so the game opens one file instead of one per asset. Run it again whenever an asset changes.
+///
+/// usage: asset_packer <asset dir> [output file]
+
+
+
+
+const unsigned int PACK_MAGIC = 0x4B505747;
+const unsigned int PACK_VERSION = 1;
+const unsigned int DATA_ALIGNMENT = 16;
+
+/// only game data is packed; scores, replays, settings, profiler output and caches written next to it are not.
+const char* const ASSET_EXTENSIONS[] = { ".png", ".jpg", ".wav", ".ogg", ".ttf" };
+const char* const ATLAS_TABLE = "atlas.txt";
+
+
+/// same layout as AssetPackEntry in GameClasses.h.
+struct PackEntry {
+    unsigned int hash;
+    unsigned int nameOffset;
+    unsigned int nameLength;
+    unsigned int reserved;
+    unsigned long long dataOffset;
+    unsigned long long dataSize;
+};
+
+
+struct PackFile {
+    string name;
+    filesystem::path path;
+    unsigned long long size;
+    PackEntry entry;
+};
+
+
+/// purpose: FNV-1a over the file name, matching hashBytes(HASH_SEED, ...) in the game.
+unsigned int hashName(const string& name) {
+    unsigned int hash = 2166136261u;
+    for (unsigned char c : name) {
+        hash ^= c;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+
+bool isAssetFile(const filesystem::path& path) {
+    if (path.filename() == ATLAS_TABLE) return true;
+    string extension = path.extension().string();
+    transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return (char)tolower(c); });
+    for (const char* assetExtension : ASSET_EXTENSIONS) {
+        if (extension == assetExtension) return true;
+    }
+    return false;
+}
+
+
+unsigned long long alignUp(unsigned long long offset) {
+    return (offset + DATA_ALIGNMENT - 1) / DATA_ALIGNMENT * DATA_ALIGNMENT;
+}
+
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        cout << "usage: asset_packer <asset dir> [output file]" << endl;
+        return 1;
+    }
+
+    filesystem::path assetDir = argv[1];
+    filesystem::path outputPath = (argc > 2) ? filesystem::path(argv[2]) : assetDir / "assets.pak";
+
+    vector<PackFile> files;
+    for (const auto& file : filesystem::directory_iterator(assetDir)) {
+        if (!file.is_regular_file()) continue;
+
+        string name = file.path().filename().string();
+        if (name[0] == '.' || !isAssetFile(file.path())) continue;
+
+        PackFile packed;
+        packed.name = name;
+        packed.path = file.path();
+        packed.size = (unsigned long long)file.file_size();
+        packed.entry.hash = hashName(name);
+        files.push_back(packed);
+    }
+
+    sort(files.begin(), files.end(), [](const PackFile& a, const PackFile& b) {
+        if (a.entry.hash != b.entry.hash) return a.entry.hash < b.entry.hash;
+        return a.name < b.name;
+    });
+
+    unsigned int header[4] = { PACK_MAGIC, PACK_VERSION, (unsigned int)files.size(), 0 };
+    unsigned long long namesStart = sizeof(header) + files.size() * sizeof(PackEntry);
+    unsigned long long namesSize = 0;
+    for (PackFile& packed : files) {
+        packed.entry.nameOffset = (unsigned int)namesSize;
+        packed.entry.nameLength = (unsigned int)packed.name.size();
+        packed.entry.reserved = 0;
+        namesSize += packed.name.size();
+    }
+
+    unsigned long long offset = alignUp(namesStart + namesSize);
+    for (PackFile& packed : files) {
+        packed.entry.dataOffset = offset;
+        packed.entry.dataSize = packed.size;
+        offset = alignUp(offset + packed.size);
+    }
+
+    ofstream pack(outputPath, ios::binary);
+    if (!pack.is_open()) {
+        cout << "Cannot write " << outputPath.string() << endl;
+        return 1;
+    }
+
+    pack.write((const char*)header, sizeof(header));
+    for (const PackFile& packed : files) {
+        pack.write((const char*)&packed.entry, sizeof(packed.entry));
+    }
+    for (const PackFile& packed : files) {
+        pack.write(packed.name.data(), packed.name.size());
+    }
+
+    vector<char> buffer;
+    for (const PackFile& packed : files) {
+        while ((unsigned long long)pack.tellp() < packed.entry.dataOffset) {
+            pack.put('\0');
+        }
+
+        ifstream source(packed.path, ios::binary);
+        buffer.resize((size_t)packed.size);
+        if (!source.read(buffer.data(), (streamsize)packed.size)) {
+            cout << "Cannot read " << packed.name << endl;
+            return 1;
+        }
+        pack.write(buffer.data(), (streamsize)packed.size);
+    }
+
+    if (!pack) {
+        cout << "Cannot write " << outputPath.string() << endl;
+        return 1;
+    }
+
+    cout << "Packed " << files.size() << " files into " << outputPath.string() << " (" << offset << " bytes)" << endl;
+    return 0;
+}
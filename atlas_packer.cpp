@@ -0,0 +1,136 @@
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+using namespace std;
+
+
+/// Build-time tool: packs the small PNGs of an asset folder into atlas pages and writes atlas.txt,
+/// which TextureCache reads at startup to resolve file names such as "enemyRed1.png" to page regions.
+///
+/// usage: atlas_packer <asset dir> [output dir]
+
+
+
+
+const unsigned int PAGE_SIZE = 2048;
+const unsigned int PADDING = 2;
+
+
+struct PackedImage {
+    string name;
+    sf::Image image;
+    unsigned int page;
+    unsigned int x;
+    unsigned int y;
+};
+
+
+/// purpose: shelf packer; images sorted tallest first fill rows left to right, rows stack downwards, pages follow.
+/// return: number of pages used.
+unsigned int packShelves(vector<PackedImage>& images, vector<unsigned int>& pageHeights) {
+    sort(images.begin(), images.end(), [](const PackedImage& a, const PackedImage& b) {
+        if (a.image.getSize().y != b.image.getSize().y) return a.image.getSize().y > b.image.getSize().y;
+        return a.name < b.name;
+    });
+
+    unsigned int page = 0;
+    unsigned int cursorX = 0;
+    unsigned int shelfY = 0;
+    unsigned int shelfHeight = 0;
+    pageHeights.assign(1, 0);
+
+    for (PackedImage& packed : images) {
+        sf::Vector2u size = packed.image.getSize();
+        unsigned int w = size.x + PADDING;
+        unsigned int h = size.y + PADDING;
+
+        if (cursorX + w > PAGE_SIZE) {
+            shelfY += shelfHeight;
+            cursorX = 0;
+            shelfHeight = 0;
+        }
+        if (shelfY + h > PAGE_SIZE) {
+            page++;
+            pageHeights.push_back(0);
+            cursorX = 0;
+            shelfY = 0;
+            shelfHeight = 0;
+        }
+
+        packed.page = page;
+        packed.x = cursorX;
+        packed.y = shelfY;
+        cursorX += w;
+        shelfHeight = max(shelfHeight, h);
+        pageHeights[page] = max(pageHeights[page], shelfY + h);
+    }
+    return page + 1;
+}
+
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        cout << "usage: atlas_packer <asset dir> [output dir]" << endl;
+        return 1;
+    }
+
+    filesystem::path assetDir = argv[1];
+    filesystem::path outputDir = (argc > 2) ? filesystem::path(argv[2]) : assetDir;
+
+    vector<PackedImage> images;
+    for (const auto& file : filesystem::directory_iterator(assetDir)) {
+        string name = file.path().filename().string();
+        if (file.path().extension() != ".png" || name.rfind("atlas", 0) == 0) continue;
+
+        PackedImage packed;
+        packed.name = name;
+        if (!packed.image.loadFromFile(file.path().string())) {
+            cout << "Skipping unreadable image: " << name << endl;
+            continue;
+        }
+
+        sf::Vector2u size = packed.image.getSize();
+        if (size.x + PADDING > PAGE_SIZE || size.y + PADDING > PAGE_SIZE) {
+            cout << "Skipping " << name << " (" << size.x << "x" << size.y << " does not fit a page)" << endl;
+            continue;
+        }
+        images.push_back(packed);
+    }
+
+    vector<unsigned int> pageHeights;
+    unsigned int pageCount = packShelves(images, pageHeights);
+
+    ofstream table((outputDir / "atlas.txt").string());
+    if (!table.is_open()) {
+        cout << "Cannot write " << (outputDir / "atlas.txt").string() << endl;
+        return 1;
+    }
+    table << "# name page x y width height" << endl;
+
+    for (unsigned int p = 0; p < pageCount; p++) {
+        sf::Image page;
+        page.create(PAGE_SIZE, pageHeights[p], sf::Color::Transparent);
+
+        for (const PackedImage& packed : images) {
+            if (packed.page != p) continue;
+
+            page.copy(packed.image, packed.x, packed.y);
+            sf::Vector2u size = packed.image.getSize();
+            table << packed.name << " atlas" << p << ".png " << packed.x << " " << packed.y << " "
+                << size.x << " " << size.y << endl;
+        }
+
+        string pageName = "atlas" + to_string(p) + ".png";
+        if (!page.saveToFile((outputDir / pageName).string())) {
+            cout << "Cannot write " << pageName << endl;
+            return 1;
+        }
+    }
+
+    cout << "Packed " << images.size() << " images into " << pageCount << " page(s)" << endl;
+    return 0;
+}
@@ -0,0 +1,329 @@
+#include "GameClasses.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <vector>
+using namespace std;
+
+
+/// Microbenchmarks for the engine hot paths. Everything runs headless, so no window or GPU is needed.
+/// Results are printed as JSON (one object per benchmark) to stdout, or to the file given with --out.
+///
+/// usage: galaxy_bench [--filter text] [--out results.json] [--min-time seconds]
+
+
+
+
+struct BenchResult {
+    string name;
+    long long param;
+    long long samples;
+    long long operations;
+    double nsPerOp;
+    double medianSampleNs;
+    double minSampleNs;
+};
+
+
+/// purpose: times body() repeatedly until minTime seconds of measured work have passed; setup() runs untimed
+///          before every sample so benchmarks that consume their input can rebuild it. A benchmark whose setup
+///          dominates stops once ten times minTime has passed on the wall clock.
+/// parameters: body returns how many operations one sample performed.
+class BenchRunner {
+private:
+    string filter;
+    double minTime;
+    vector<BenchResult> results;
+
+public:
+    BenchRunner(const string& nameFilter, double minSeconds) : filter(nameFilter), minTime(minSeconds) {}
+
+    void run(const string& name, long long param, const function<void()>& setup, const function<long long()>& body) {
+        if (!filter.empty() && name.find(filter) == string::npos) return;
+
+        vector<double> sampleNs;
+        long long operations = 0;
+        double totalNs = 0.0;
+
+        setup();
+        body();
+
+        auto wallStart = chrono::steady_clock::now();
+        while (totalNs < minTime * 1.0e9 || sampleNs.size() < 5) {
+            if (sampleNs.size() >= 5 && chrono::steady_clock::now() - wallStart > chrono::duration<double>(minTime * 10.0)) {
+                break;
+            }
+
+            setup();
+            auto start = chrono::steady_clock::now();
+            long long ops = body();
+            auto stop = chrono::steady_clock::now();
+
+            double ns = (double)chrono::duration_cast<chrono::nanoseconds>(stop - start).count();
+            sampleNs.push_back(ns);
+            totalNs += ns;
+            operations += ops;
+        }
+
+        sort(sampleNs.begin(), sampleNs.end());
+
+        BenchResult result;
+        result.name = name;
+        result.param = param;
+        result.samples = (long long)sampleNs.size();
+        result.operations = operations;
+        result.nsPerOp = (operations > 0) ? totalNs / operations : 0.0;
+        result.medianSampleNs = sampleNs[sampleNs.size() / 2];
+        result.minSampleNs = sampleNs[0];
+        results.push_back(result);
+
+        cerr << name << "/" << param << ": " << result.nsPerOp << " ns/op" << endl;
+    }
+
+    void writeJson(ostream& out) const {
+        out << "{\n  \"benchmarks\": [\n";
+        for (size_t i = 0; i < results.size(); i++) {
+            const BenchResult& r = results[i];
+            out << "    { \"name\": \"" << r.name << "\", \"param\": " << r.param
+                << ", \"samples\": " << r.samples << ", \"operations\": " << r.operations
+                << ", \"ns_per_op\": " << r.nsPerOp << ", \"median_sample_ns\": " << r.medianSampleNs
+                << ", \"min_sample_ns\": " << r.minSampleNs << " }";
+            out << (i + 1 < results.size() ? ",\n" : "\n");
+        }
+        out << "  ]\n}\n";
+    }
+};
+
+
+struct BenchEntity {
+    float x, y;
+    bool active;
+    bool isActive() const { return active; }
+};
+
+
+/// keeps the optimiser from discarding results that are otherwise unused.
+volatile long long benchSink = 0;
+
+
+
+
+void benchObjectPool(BenchRunner& runner) {
+    const int sizes[] = { 64, 1024, 16384 };
+    for (int size : sizes) {
+        ObjectPool<BenchEntity> pool(size);
+        PoolHandle* handles = new PoolHandle[size];
+
+        runner.run("object_pool_acquire_release", size, [&]() { pool.clear(); }, [&]() {
+            for (int i = 0; i < size; i++) {
+                handles[i] = pool.acquire();
+            }
+            for (int i = 0; i < size; i++) {
+                pool.release(handles[i]);
+            }
+            return (long long)size * 2;
+        });
+
+        runner.run("object_pool_release_scattered", size, [&]() {
+            pool.clear();
+            for (int i = 0; i < size; i++) {
+                handles[i] = pool.acquire();
+            }
+        }, [&]() {
+            for (int i = 0; i < size; i += 2) {
+                pool.release(handles[i]);
+            }
+            for (int i = 1; i < size; i += 2) {
+                pool.release(handles[i]);
+            }
+            return (long long)size;
+        });
+
+        delete[] handles;
+    }
+}
+
+
+void benchCollisions(BenchRunner& runner, Level1& level) {
+    const int counts[] = { 32, 128, 512, 2048, 8192 };
+    for (int n : counts) {
+        runner.run("level1_collisions", n, [&]() {
+            level.spawnStressEntities(n, n, n, 1234);
+        }, [&]() {
+            level.checkCollisions();
+            benchSink += level.getScore();
+            return 1LL;
+        });
+    }
+    level.reset();
+}
+
+
+void benchLevelUpdate(BenchRunner& runner, Level1& level) {
+    const long ticksPerSample = 1200;
+    AutoPilot pilot(7);
+    long tick = 0;
+
+    runner.run("level1_update", ticksPerSample, [&]() {
+        if (level.isPlayerDestroyed() || tick > MAX_SIMULATED_LEVEL_TICKS) {
+            level.reset();
+            tick = 0;
+        }
+    }, [&]() {
+        for (long t = 0; t < ticksPerSample; t++, tick++) {
+            level.update(SIMULATION_DT, pilot.next(level, tick));
+        }
+        return (long long)ticksPerSample;
+    });
+    level.reset();
+}
+
+
+const char* const BENCH_JOURNAL = "bench_highscores.dat";
+
+
+/// purpose: an append-only journal as it looks after `records` games, before any compaction.
+void writeScoreJournal(int records) {
+    ofstream fileOut(BENCH_JOURNAL, ios::binary);
+    unsigned int header[2] = { SCORE_JOURNAL_MAGIC, SCORE_JOURNAL_VERSION };
+    fileOut.write((const char*)header, sizeof(header));
+    for (int i = 0; i < records; i++) {
+        ScoreRecord record = ScoreJournal::makeRecord("Pilot" + to_string(i), (i * 7919) % 100000, 60 + i % 500);
+        fileOut.write((const char*)&record, sizeof(record));
+    }
+}
+
+
+void benchHighScores(BenchRunner& runner) {
+    const int sizes[] = { 50, 10000, 1000000 };
+    for (int records : sizes) {
+        writeScoreJournal(records);
+
+        runner.run("highscore_load", records, []() {}, [&]() {
+            Leaderboard leaderboard(BENCH_JOURNAL);
+            leaderboard.refresh();
+            benchSink += leaderboard.getCount();
+            return 1LL;
+        });
+
+        Leaderboard leaderboard(BENCH_JOURNAL);
+        HighScoreScreen screen;
+        screen.loadScores(leaderboard);
+        runner.run("highscore_open_cached", records, []() {}, [&]() {
+            screen.loadScores(leaderboard);
+            return 1LL;
+        });
+    }
+
+    {
+        ScoreJournal journal(BENCH_JOURNAL);
+        runner.run("highscore_submit", 1, [&]() { journal.flush(); }, [&]() {
+            journal.submit("Bench", 12345, 321);
+            return 1LL;
+        });
+        journal.flush();
+
+        runner.run("highscore_save_durable", SCORE_JOURNAL_COMPACT_AT, []() {}, [&]() {
+            for (int i = 0; i < SCORE_JOURNAL_COMPACT_AT; i++) {
+                journal.submit("Bench", i, 321);
+            }
+            journal.flush();
+            return (long long)SCORE_JOURNAL_COMPACT_AT;
+        });
+    }
+
+    remove(BENCH_JOURNAL);
+}
+
+
+void benchImageDecode(BenchRunner& runner) {
+    const char* const images[] = { "enemyRed1.png", "bg4.jpg" };
+    for (const char* path : images) {
+        sf::Image image;
+        if (!image.loadFromFile(path)) continue;
+        long long pixels = (long long)image.getSize().x * image.getSize().y;
+
+        runner.run("image_decode_source", pixels, []() {}, [&]() {
+            image.loadFromFile(path);
+            return 1LL;
+        });
+
+        PixelCache::shared().decode(path, image);
+        runner.run("image_decode_pixel_cache", pixels, []() {}, [&]() {
+            PixelCache::shared().decode(path, image);
+            return 1LL;
+        });
+    }
+}
+
+
+void benchTypewriter(BenchRunner& runner) {
+    sf::Font font;
+    font.loadFromFile("arial.ttf");
+
+    const int lengths[] = { 32, 256, 2048 };
+    for (int length : lengths) {
+        TypewriterText typewriter;
+        typewriter.setup(string(length, 'W'), font, 60, sf::Color::White);
+
+        runner.run("typewriter_update", length, [&]() { typewriter.start(); }, [&]() {
+            long long updates = 0;
+            while (!typewriter.isDone()) {
+                typewriter.update(0.05f);
+                updates++;
+            }
+            return updates;
+        });
+    }
+}
+
+
+
+
+int main(int argc, char* argv[]) {
+    string filter;
+    string outPath;
+    double minTime = 0.5;
+
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--filter" && i + 1 < argc) {
+            filter = argv[++i];
+        }
+        else if (arg == "--out" && i + 1 < argc) {
+            outPath = argv[++i];
+        }
+        else if (arg == "--min-time" && i + 1 < argc) {
+            minTime = atof(argv[++i]);
+        }
+    }
+
+    headlessMode = true;
+    BenchRunner runner(filter, minTime);
+
+    Level1 level;
+    level.loadAssets();
+    level.reset();
+
+    benchObjectPool(runner);
+    benchCollisions(runner, level);
+    benchLevelUpdate(runner, level);
+    benchHighScores(runner);
+    benchImageDecode(runner);
+    benchTypewriter(runner);
+
+    if (outPath.empty()) {
+        runner.writeJson(cout);
+    }
+    else {
+        ofstream out(outPath);
+        if (!out) {
+            cerr << "Cannot write " << outPath << endl;
+            return 1;
+        }
+        runner.writeJson(out);
+    }
+    return 0;
+}
@@ -3,8 +3,46 @@
 using namespace std;
 
 
-int main() {
+int main(int argc, char* argv[]) {
+    PROFILER_REGISTER_THREAD();
+    int simulatedGames = 0;
+    unsigned int seed = 1;
+    string replayPath;
+    bool headless = false;
+
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--simulate" && i + 1 < argc) {
+            simulatedGames = atoi(argv[++i]);
+        }
+        else if (arg == "--seed" && i + 1 < argc) {
+            seed = (unsigned int)strtoul(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--replay" && i + 1 < argc) {
+            replayPath = argv[++i];
+        }
+        else if (arg == "--headless") {
+            headless = true;
+        }
+    }
+
+    if (!replayPath.empty() && headless) {
+        headlessMode = true;
+        HeadlessSimulator simulator;
+        return simulator.playReplay(replayPath) ? 0 : 1;
+    }
+
+    if (simulatedGames > 0) {
+        headlessMode = true;
+        HeadlessSimulator simulator;
+        simulator.run(simulatedGames, seed);
+        return 0;
+    }
+
     Game game;
+    if (!replayPath.empty() && !game.playReplay(replayPath)) {
+        return 1;
+    }
     game.run();
     return 0;
 }
@@ -0,0 +1,64 @@
+#include "GameClasses.h"
+#include <iostream>
+using namespace std;
+
+
+/// Headless build of the game: plays complete games with the autopilot and never opens a window.
+///
+/// usage: galaxy_sim [games] [--seed S]
+///        galaxy_sim --replay file.gwr
+///        galaxy_sim --sweep games-per-config [--threads N] [--out sweep.csv] [--seed S]
+
+
+int main(int argc, char* argv[]) {
+    PROFILER_REGISTER_THREAD();
+    int games = 100;
+    unsigned int seed = 1;
+    string replayPath;
+    int sweepGames = 0;
+    int threads = 0;
+    string outPath = "sweep.csv";
+
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--seed" && i + 1 < argc) {
+            seed = (unsigned int)strtoul(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--replay" && i + 1 < argc) {
+            replayPath = argv[++i];
+        }
+        else if (arg == "--sweep" && i + 1 < argc) {
+            sweepGames = atoi(argv[++i]);
+        }
+        else if (arg == "--threads" && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        }
+        else if (arg == "--out" && i + 1 < argc) {
+            outPath = argv[++i];
+        }
+        else {
+            games = atoi(argv[i]);
+        }
+    }
+
+    headlessMode = true;
+
+    if (sweepGames > 0) {
+        BatchSimulator batch;
+        batch.addDefaultSweep();
+        batch.run(sweepGames, seed, threads);
+        if (!batch.writeCsv(outPath)) {
+            cout << "Cannot write " << outPath << endl;
+            return 1;
+        }
+        cout << "Results written to " << outPath << endl;
+        return 0;
+    }
+
+    HeadlessSimulator simulator;
+    if (!replayPath.empty()) {
+        return simulator.playReplay(replayPath) ? 0 : 1;
+    }
+    simulator.run(games, seed);
+    return 0;
+}